@@ -14,11 +14,16 @@
 
 #define MAX_Z_FADE_DISTANCE 32.0
 
-// Vertex attributes (inputs)
+// Landscape tile shapes split along the other diagonal (0110, 0111, 1110, 1111),
+// and the unused shape drawn as degenerate triangles (1000).
+#define OTHER_DIAGONAL_SHAPES 0xC0C0u
+#define UNUSED_SHAPES 0x0100u
+
+// Vertex attributes (inputs), matching PackedVertex
 layout(location = 0) in vec3 a_position;
-layout(location = 1) in vec3 a_normal;
+layout(location = 1) in vec2 a_normal;      // octahedral encoding
 layout(location = 2) in uint a_colour;
-layout(location = 3) in vec2 a_texcoord;
+layout(location = 3) in uint a_texcoord;    // bit 0 = u, bit 1 = v
 
 // Uniform block (must match C++ VertexConstants struct with std140 layout)
 layout(std140) uniform VertexConstants
@@ -31,29 +36,106 @@ layout(std140) uniform VertexConstants
     float fog_density;              // 4 bytes
     uint fog_colour_idx;            // 4 bytes
     uint lighting;                  // 4 bytes
-    uint padding;                   // 4 bytes (alignment)
+    uint heightfield;               // 4 bytes (generate landscape vertices)
 };
 
+// Landscape map entries (height << 4 | tile shape), one texel per map point
+uniform usampler2D u_heightmap;
+
 // Outputs to fragment shader
 out vec4 v_colour;
 out vec2 v_texcoord;
 
+// Model position of a landscape tile corner (0-3, in rows of increasing x)
+vec3 LandscapeCorner(ivec2 tile, int corner, int tiles)
+{
+    ivec2 map_pos = tile + ivec2(corner & 1, corner >> 1);
+    uint entry = texelFetch(u_heightmap, map_pos, 0).r;
+    vec2 xz = vec2(map_pos - (tiles + 1) / 2) - 0.5;
+    return vec3(xz.x, float(entry >> 4), xz.y);
+}
+
+// Generate the vertex that Spectrum::ExtractLandscape would have stored at
+// this index: 6 vertices per tile, with tiles in rows of increasing x.
+void LandscapeVertex(out vec3 position, out vec3 normal, out uint colour, out vec2 texcoord)
+{
+    int tiles = textureSize(u_heightmap, 0).x - 1;
+    int tile_index = gl_VertexID / 6;
+    int vertex = gl_VertexID % 6;
+    ivec2 tile = ivec2(tile_index % tiles, tile_index / tiles);
+
+    uint shape = texelFetch(u_heightmap, tile, 0).r & 0xfu;
+    uint shape_bit = 1u << shape;
+
+    const int corners[6] = int[6](0, 2, 3, 0, 3, 1);
+    const int other_corners[6] = int[6](0, 2, 1, 1, 2, 3);
+
+    // Corners of the triangle holding this vertex
+    int first = vertex - (vertex % 3);
+    vec3 triangle[3];
+    int corner = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        int c = 0;
+        if ((shape_bit & UNUSED_SHAPES) == 0u)
+            c = ((shape_bit & OTHER_DIAGONAL_SHAPES) != 0u) ? other_corners[first + i] : corners[first + i];
+
+        triangle[i] = LandscapeCorner(tile, c, tiles);
+        if (first + i == vertex)
+            corner = c;
+    }
+
+    position = triangle[vertex % 3];
+    texcoord = vec2(corner & 1, corner >> 1);
+
+    // Face normal, left as zero for degenerate triangles
+    vec3 n = cross(triangle[1] - triangle[0], triangle[2] - triangle[1]);
+    normal = (dot(n, n) > 0.0) ? normalize(n) : vec3(0.0);
+
+    // Checkerboard, with different colours for flat and sloped tiles
+    bool alt_colour = ((tile.x ^ tile.y) & 1) != 0;
+    if (shape != 0u)
+        colour = alt_colour ? 0x10u : 0x11u;
+    else
+        colour = alt_colour ? 0x1u : 0x3u;
+}
+
+// Unit normal from its octahedral encoding
+vec3 OctahedralDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * s;
+    }
+    return normalize(n);
+}
+
 void main()
 {
+    vec3 position = a_position;
+    vec3 normal = OctahedralDecode(a_normal);
+    uint colour = a_colour;
+    vec2 texcoord = vec2(float(a_texcoord & 1u), float((a_texcoord >> 1) & 1u));
+
+    if (heightfield != 0u)
+        LandscapeVertex(position, normal, colour, texcoord);
+
     // Transform position to clip space
     // Note: Matrices are transposed when uploaded from DirectXMath (row-major) to GLSL (column-major)
-    gl_Position = WVP * vec4(a_position, 1.0);
-    v_texcoord = a_texcoord;
+    gl_Position = WVP * vec4(position, 1.0);
+    v_texcoord = texcoord;
 
     float lightLevel = 1.0;
 
     if (lighting != 0u)
     {
         // Transform the model normal into a world direction
-        vec3 transformedNormal = mat3(W) * a_normal;
+        vec3 transformedNormal = mat3(W) * normal;
 
         // Determine direction of the vertex from the eye position
-        vec3 vertexDir = (W * vec4(a_position, 1.0)).xyz - EyePos;
+        vec3 vertexDir = (W * vec4(position, 1.0)).xyz - EyePos;
 
         // If the front face is visible we'll use normal lighting
         if (dot(vertexDir, transformedNormal) < 0.0)
@@ -78,13 +160,13 @@ void main()
         }
     }
 
-    vec4 face_colour = clamp(lightLevel, 0.0, 1.0) * Palette[a_colour];
+    vec4 face_colour = clamp(lightLevel, 0.0, 1.0) * Palette[colour];
     float fog_level = 1.0 / exp(length(gl_Position.xyz) * fog_density);
     v_colour = mix(Palette[fog_colour_idx], face_colour, fog_level);
 
     if (z_fade > 0.0)
     {
-        float z = (W * vec4(a_position, 1.0)).z;
+        float z = (W * vec4(position, 1.0)).z;
         z = clamp(z, 0.0, MAX_Z_FADE_DISTANCE);
 
         float fade = 1.0 / exp(z * z_fade);
@@ -16,8 +16,11 @@ enum class Action
 	LandscapeLast,
 	LandscapePgUp,
 	LandscapePgDn,
+	LandscapeFilter,
+	LandscapeGrid,
 	Quit,
 	Pause,
+	Turbo,
 	Absorb,
 	Tree,
 	Boulder,
@@ -0,0 +1,266 @@
+#include "Platform.h"
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#ifdef TRACK_ALLOCATIONS
+
+namespace
+{
+	// Nothing here may allocate, as it runs inside operator new.
+	struct Counters
+	{
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> frees{ 0 };
+		std::atomic<uint64_t> bytes{ 0 };
+	};
+
+	struct Scope
+	{
+		const char* name{ nullptr };
+		std::atomic<uint64_t> frame_allocations{ 0 };
+		std::atomic<uint64_t> frame_bytes{ 0 };
+		std::atomic<uint64_t> total_allocations{ 0 };
+		std::atomic<uint64_t> total_bytes{ 0 };
+		uint64_t last_allocations{ 0 };
+		uint64_t last_bytes{ 0 };
+	};
+
+	Counters frame_counts, total_counts;
+	AllocTracker::Counts last_frame;
+	std::atomic<uint64_t> live_bytes{ 0 };
+	std::atomic<uint64_t> frame_peak{ 0 };
+	std::atomic<uint64_t> total_peak{ 0 };
+
+	std::array<Scope, AllocTracker::MAX_SCOPES> scopes;
+	std::atomic<int> scope_count{ 0 };
+	std::mutex scope_mutex;
+	thread_local int current_scope = -1;
+
+	// Each block starts with its size, so frees can be counted in bytes.
+	constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+	void UpdatePeak(std::atomic<uint64_t>& peak, uint64_t value)
+	{
+		auto old_peak = peak.load(std::memory_order_relaxed);
+		while (value > old_peak && !peak.compare_exchange_weak(old_peak, value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void* TrackedAlloc(size_t size)
+	{
+		auto p = static_cast<uint8_t*>(std::malloc(size + HEADER_SIZE));
+		if (!p)
+			return nullptr;
+
+		*reinterpret_cast<size_t*>(p) = size;
+
+		frame_counts.allocations.fetch_add(1, std::memory_order_relaxed);
+		frame_counts.bytes.fetch_add(size, std::memory_order_relaxed);
+		total_counts.allocations.fetch_add(1, std::memory_order_relaxed);
+		total_counts.bytes.fetch_add(size, std::memory_order_relaxed);
+
+		auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+		UpdatePeak(frame_peak, live);
+		UpdatePeak(total_peak, live);
+
+		if (current_scope >= 0)
+		{
+			auto& scope = scopes[current_scope];
+			scope.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+			scope.frame_bytes.fetch_add(size, std::memory_order_relaxed);
+			scope.total_allocations.fetch_add(1, std::memory_order_relaxed);
+			scope.total_bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		return p + HEADER_SIZE;
+	}
+
+	void TrackedFree(void* ptr)
+	{
+		if (!ptr)
+			return;
+
+		auto p = static_cast<uint8_t*>(ptr) - HEADER_SIZE;
+		live_bytes.fetch_sub(*reinterpret_cast<size_t*>(p), std::memory_order_relaxed);
+		frame_counts.frees.fetch_add(1, std::memory_order_relaxed);
+		total_counts.frees.fetch_add(1, std::memory_order_relaxed);
+
+		std::free(p);
+	}
+
+	void* TrackedNew(size_t size)
+	{
+		if (auto p = TrackedAlloc(size ? size : 1))
+			return p;
+
+		throw std::bad_alloc();
+	}
+}
+
+void* operator new(size_t size) { return TrackedNew(size); }
+void* operator new[](size_t size) { return TrackedNew(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size ? size : 1); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size ? size : 1); }
+void operator delete(void* p) noexcept { TrackedFree(p); }
+void operator delete[](void* p) noexcept { TrackedFree(p); }
+void operator delete(void* p, size_t) noexcept { TrackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { TrackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { TrackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { TrackedFree(p); }
+
+AllocScope::AllocScope(const char* name)
+	: m_previous(current_scope)
+{
+	// Find the scope by name, adding it the first time it's seen.
+	auto count = scope_count.load(std::memory_order_acquire);
+	for (int i = 0; i < count; ++i)
+	{
+		if (scopes[i].name == name || !strcmp(scopes[i].name, name))
+		{
+			current_scope = i;
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(scope_mutex);
+	count = scope_count.load(std::memory_order_relaxed);
+	for (int i = 0; i < count; ++i)
+	{
+		if (!strcmp(scopes[i].name, name))
+		{
+			current_scope = i;
+			return;
+		}
+	}
+
+	// Allocations in scopes beyond the table size stay with the outer scope.
+	if (count < AllocTracker::MAX_SCOPES)
+	{
+		scopes[count].name = name;
+		scope_count.store(count + 1, std::memory_order_release);
+		current_scope = count;
+	}
+}
+
+AllocScope::~AllocScope()
+{
+	current_scope = m_previous;
+}
+
+/*static*/ bool AllocTracker::IsEnabled()
+{
+	return true;
+}
+
+/*static*/ void AllocTracker::NewFrame()
+{
+	last_frame.allocations = frame_counts.allocations.exchange(0);
+	last_frame.frees = frame_counts.frees.exchange(0);
+	last_frame.bytes = frame_counts.bytes.exchange(0);
+	last_frame.peak_bytes = frame_peak.exchange(live_bytes.load());
+
+	auto count = scope_count.load(std::memory_order_acquire);
+	for (int i = 0; i < count; ++i)
+	{
+		scopes[i].last_allocations = scopes[i].frame_allocations.exchange(0);
+		scopes[i].last_bytes = scopes[i].frame_bytes.exchange(0);
+	}
+}
+
+/*static*/ AllocTracker::Counts AllocTracker::GetLastFrame()
+{
+	return last_frame;
+}
+
+/*static*/ AllocTracker::Counts AllocTracker::GetTotals()
+{
+	return { total_counts.allocations.load(), total_counts.frees.load(), total_counts.bytes.load(), total_peak.load() };
+}
+
+/*static*/ uint64_t AllocTracker::GetLiveBytes()
+{
+	return live_bytes;
+}
+
+/*static*/ std::vector<AllocTracker::ScopeCounts> AllocTracker::GetLastFrameScopes()
+{
+	std::vector<ScopeCounts> counts;
+	auto count = scope_count.load(std::memory_order_acquire);
+	for (int i = 0; i < count; ++i)
+		counts.push_back({ scopes[i].name, scopes[i].last_allocations, scopes[i].last_bytes });
+	return counts;
+}
+
+/*static*/ std::vector<AllocTracker::ScopeCounts> AllocTracker::GetTotalScopes()
+{
+	std::vector<ScopeCounts> counts;
+	auto count = scope_count.load(std::memory_order_acquire);
+	for (int i = 0; i < count; ++i)
+		counts.push_back({ scopes[i].name, scopes[i].total_allocations.load(), scopes[i].total_bytes.load() });
+	return counts;
+}
+
+#else
+
+/*static*/ bool AllocTracker::IsEnabled()
+{
+	return false;
+}
+
+/*static*/ void AllocTracker::NewFrame()
+{
+}
+
+/*static*/ AllocTracker::Counts AllocTracker::GetLastFrame()
+{
+	return {};
+}
+
+/*static*/ AllocTracker::Counts AllocTracker::GetTotals()
+{
+	return {};
+}
+
+/*static*/ uint64_t AllocTracker::GetLiveBytes()
+{
+	return 0;
+}
+
+/*static*/ std::vector<AllocTracker::ScopeCounts> AllocTracker::GetLastFrameScopes()
+{
+	return {};
+}
+
+/*static*/ std::vector<AllocTracker::ScopeCounts> AllocTracker::GetTotalScopes()
+{
+	return {};
+}
+
+#endif
+
+/*static*/ void AllocTracker::Report()
+{
+	if (!IsEnabled())
+		return;
+
+	auto totals = GetTotals();
+	SDL_Log("=== Heap Allocations ===");
+	SDL_Log("  Allocations: %llu  Frees: %llu  Bytes: %llu  Peak Live: %.1f KB  Live: %.1f KB",
+		static_cast<unsigned long long>(totals.allocations),
+		static_cast<unsigned long long>(totals.frees),
+		static_cast<unsigned long long>(totals.bytes),
+		totals.peak_bytes / 1024.0f, GetLiveBytes() / 1024.0f);
+
+	for (auto& scope : GetTotalScopes())
+	{
+		SDL_Log("  %-12s %10llu allocations %12llu bytes", scope.name,
+			static_cast<unsigned long long>(scope.allocations),
+			static_cast<unsigned long long>(scope.bytes));
+	}
+	SDL_Log("========================");
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// Heap allocation counts per frame and per named scope, gathered by replacing
+// the global operator new and delete. Only built in with TRACK_ALLOCATIONS
+// (the CMake option of the same name); otherwise all counts are zero and
+// scopes compile away.
+class AllocTracker
+{
+public:
+	static constexpr int MAX_SCOPES = 16;
+
+	struct Counts
+	{
+		uint64_t allocations{ 0 };
+		uint64_t frees{ 0 };
+		uint64_t bytes{ 0 };		// allocated, not net.
+		uint64_t peak_bytes{ 0 };	// most live at once.
+	};
+
+	struct ScopeCounts
+	{
+		const char* name;
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	static bool IsEnabled();
+
+	// Start counting a new frame, keeping the counts for the one just ended.
+	static void NewFrame();
+
+	static Counts GetLastFrame();
+	static Counts GetTotals();
+	static uint64_t GetLiveBytes();
+	static std::vector<ScopeCounts> GetLastFrameScopes();
+	static std::vector<ScopeCounts> GetTotalScopes();
+
+	// Log the totals, for the report at exit.
+	static void Report();
+};
+
+// Attributes allocations on this thread to a named scope while it exists.
+// Nested scopes take the allocations from the outer one. Names must be
+// string literals.
+class AllocScope
+{
+public:
+#ifdef TRACK_ALLOCATIONS
+	explicit AllocScope(const char* name);
+	~AllocScope();
+#else
+	explicit AllocScope(const char*) {}
+#endif
+	AllocScope(const AllocScope&) = delete;
+	AllocScope& operator=(const AllocScope&) = delete;
+
+#ifdef TRACK_ALLOCATIONS
+private:
+	int m_previous;
+#endif
+};
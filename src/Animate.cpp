@@ -1,6 +1,20 @@
 #include "Platform.h"
 #include "Animate.h"
 
+static void ApplyAnimation(Model& model, AnimationType type, float value)
+{
+	switch (type)
+	{
+	case AnimationType::Dissolve:
+		model.dissolved = value;
+		break;
+
+	case AnimationType::Yaw:
+		model.rot.y = value;
+		break;
+	}
+}
+
 void AnimateModels(std::vector<Animation>& animations, float elapsed, IModelSource* model_source)
 {
 	for (auto it = animations.begin(); it != animations.end(); )
@@ -20,16 +34,7 @@ void AnimateModels(std::vector<Animation>& animations, float elapsed, IModelSour
 		auto proportion = std::min(it->elapsed_time, it->total_time) / it->total_time;
 		auto new_value = it->start_value + (it->end_value - it->start_value) * proportion;
 
-		switch (it->type)
-		{
-		case AnimationType::Dissolve:
-			model->dissolved = new_value;
-			break;
-
-		case AnimationType::Yaw:
-			model->rot.y = new_value;
-			break;
-		}
+		ApplyAnimation(*model, it->type, new_value);
 
 		// Animation complete?
 		if (it->elapsed_time >= it->total_time)
@@ -42,3 +47,10 @@ void AnimateModels(std::vector<Animation>& animations, float elapsed, IModelSour
 		}
 	}
 }
+
+// Skip straight to the end state, without animating.
+void FinishAnimation(const Animation& animation, IModelSource* model_source)
+{
+	if (auto model = model_source->FindModelById(animation.id))
+		ApplyAnimation(*model, animation.type, animation.end_value);
+}
@@ -26,3 +26,4 @@ struct IModelSource
 };
 
 void AnimateModels(std::vector<Animation>& animations, float elapsed, IModelSource* model_source);
+void FinishAnimation(const Animation& animation, IModelSource* model_source);
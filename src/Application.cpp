@@ -3,11 +3,13 @@
 #include "OpenGLRenderer.h"
 #include "Augmentinel.h"
 #include "Settings.h"
+#include "AllocTracker.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
 static constexpr float MAX_ACCUMULATED_TIME = 0.25f;
+static constexpr float TURBO_RENDER_INTERVAL = 0.1f;  // Render at 10 fps while fast-forwarding
 
 // Global resource path
 std::string g_resourcePath;
@@ -21,6 +23,34 @@ Application::~Application()
     Shutdown();
 }
 
+void Application::InitPaths()
+{
+    char* basePath = SDL_GetBasePath();
+    if (basePath) {
+        std::string base(basePath);
+        SDL_free(basePath);
+
+#ifdef PLATFORM_MACOS
+        // Check if we're in an app bundle (path ends with .app/Contents/MacOS/)
+        if (base.find(".app/Contents/MacOS/") != std::string::npos) {
+            // Resources are in ../Resources/ relative to executable
+            g_resourcePath = base + "../Resources/";
+            // Settings stay alongside executable for easy access
+            settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
+        } else {
+            g_resourcePath = base;
+            settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
+        }
+#else
+        g_resourcePath = base;
+        settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
+#endif
+    } else {
+        g_resourcePath = "./";
+        settings_path = L"settings.ini";
+    }
+}
+
 bool Application::Init()
 {
     // Initialize SDL
@@ -91,35 +121,21 @@ bool Application::Init()
     SDL_Log("Vendor: %s", glGetString(GL_VENDOR));
 
     // Set resource and settings paths
-    char* basePath = SDL_GetBasePath();
-    if (basePath) {
-        std::string base(basePath);
-        SDL_free(basePath);
-
-#ifdef PLATFORM_MACOS
-        // Check if we're in an app bundle (path ends with .app/Contents/MacOS/)
-        if (base.find(".app/Contents/MacOS/") != std::string::npos) {
-            // Resources are in ../Resources/ relative to executable
-            g_resourcePath = base + "../Resources/";
-            // Settings stay alongside executable for easy access
-            settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
-        } else {
-            g_resourcePath = base;
-            settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
-        }
-#else
-        g_resourcePath = base;
-        settings_path = std::wstring(base.begin(), base.end()) + L"settings.ini";
-#endif
-    } else {
-        g_resourcePath = "./";
-        settings_path = L"settings.ini";
-    }
+    InitPaths();
     SDL_Log("Resource path: %s", g_resourcePath.c_str());
 
     // Initialize settings
     InitSettings(APP_NAME);
 
+    // Create the job system shared by the game, emulator and renderer
+    m_pJobs = std::make_unique<JobSystem>();
+    JobSystem::SetCurrent(m_pJobs.get());
+    SDL_Log("Job system threads: %zu", m_pJobs->Size());
+
+    // Temporary query containers on the main thread come from a per-frame arena
+    m_pFrameArena = std::make_unique<FrameArena>();
+    FrameArena::SetCurrent(m_pFrameArena.get());
+
     // Restore fullscreen state from settings
     m_fullscreen = GetFlag(L"Fullscreen", false);
     if (m_fullscreen)
@@ -173,6 +189,7 @@ bool Application::Init()
 void Application::Run(bool dumpScreenshot)
 {
     auto lastTime = std::chrono::high_resolution_clock::now();
+    auto lastRenderTime = lastTime;
     int warmupFrames = dumpScreenshot ? 10 : 0; // Wait 10 frames before screenshot
 
     // Enable debug info by default when taking screenshots
@@ -181,6 +198,11 @@ void Application::Run(bool dumpScreenshot)
 
     while (m_running)
     {
+        // Release the frame arena memory used by the last iteration
+        if (m_pFrameArena)
+            m_pFrameArena->Reset();
+        AllocTracker::NewFrame();
+
         // Process events
         SDL_Event event;
         while (SDL_PollEvent(&event))
@@ -197,9 +219,8 @@ void Application::Run(bool dumpScreenshot)
         elapsed = std::min(elapsed, MAX_ACCUMULATED_TIME);
         lastTime = currentTime;
 
-        // Update FPS counter
+        // Update FPS counter, which only counts rendered frames (see below)
         m_frameCount++;
-        m_fpsFrameCount++;
         m_avgFrameTime = elapsed * 1000.0f; // Convert to milliseconds
 
         uint32_t currentTicks = SDL_GetTicks();
@@ -213,6 +234,7 @@ void Application::Run(bool dumpScreenshot)
         // Update debug overlay every frame if enabled
         if (m_showDebugInfo && m_pDebugOverlay && m_pRenderer)
         {
+            AllocScope allocScope("Overlay");
             auto *glRenderer = dynamic_cast<OpenGLRenderer *>(m_pRenderer.get());
 
             std::vector<std::string> debugLines;
@@ -229,20 +251,117 @@ void Application::Run(bool dumpScreenshot)
 
             if (glRenderer)
             {
-                snprintf(buffer, sizeof(buffer), "Draw Calls: %u", glRenderer->GetDrawCallCount());
+                snprintf(buffer, sizeof(buffer), "Draw Calls: %u  Culled: %u",
+                         glRenderer->GetDrawCallCount(), glRenderer->GetCulledModelCount());
                 debugLines.push_back(buffer);
 
                 snprintf(buffer, sizeof(buffer), "Uploaded Models: %u", glRenderer->GetModelCount());
                 debugLines.push_back(buffer);
             }
 
+            snprintf(buffer, sizeof(buffer), "Matrix Recomputes: %u", Model::GetMatrixRecomputeCount());
+            debugLines.push_back(buffer);
+
+            if (m_pFrameArena)
+            {
+                auto arenaStats = m_pFrameArena->GetLastFrameStats();
+                snprintf(buffer, sizeof(buffer), "Frame Arena: %.1f KB of %.1f KB  Heap Fallbacks: %u",
+                         arenaStats.bytes / 1024.0f, m_pFrameArena->Capacity() / 1024.0f,
+                         arenaStats.heap_fallbacks);
+                debugLines.push_back(buffer);
+            }
+
+            if (AllocTracker::IsEnabled())
+            {
+                auto allocs = AllocTracker::GetLastFrame();
+                snprintf(buffer, sizeof(buffer), "Heap: %llu allocs  %llu frees  %.1f KB  Peak: %.1f KB",
+                         static_cast<unsigned long long>(allocs.allocations),
+                         static_cast<unsigned long long>(allocs.frees),
+                         allocs.bytes / 1024.0f, allocs.peak_bytes / 1024.0f);
+                debugLines.push_back(buffer);
+
+                for (const auto &scope : AllocTracker::GetLastFrameScopes())
+                {
+                    snprintf(buffer, sizeof(buffer), "  %s: %llu allocs  %.1f KB", scope.name,
+                             static_cast<unsigned long long>(scope.allocations), scope.bytes / 1024.0f);
+                    debugLines.push_back(buffer);
+                }
+            }
+
+            if (m_pJobs)
+            {
+                auto jobStats = m_pJobs->GetStats();
+                snprintf(buffer, sizeof(buffer), "Jobs: %llu  Steals: %llu  Latency: %.1f us avg, %llu us max",
+                         static_cast<unsigned long long>(jobStats.jobs),
+                         static_cast<unsigned long long>(jobStats.steals),
+                         jobStats.jobs ? static_cast<float>(jobStats.total_latency_us) / jobStats.jobs : 0.0f,
+                         static_cast<unsigned long long>(jobStats.max_latency_us));
+                debugLines.push_back(buffer);
+            }
+
+            // Emulation stats cover the previous frame
+            auto *augmentinel = dynamic_cast<Augmentinel *>(m_pGame.get());
+            auto *emuStats = augmentinel ? augmentinel->GetEmulationStats() : nullptr;
+            float emuTime = emuStats ? emuStats->run_time_ms : 0.0f;
+
+            snprintf(buffer, sizeof(buffer), "Emulation: %.2f ms  Game Logic: %.2f ms  Render: %.2f ms",
+                     emuTime, std::max(m_gameTime - emuTime, 0.0f), m_renderTime);
+            debugLines.push_back(buffer);
+
+            if (emuStats)
+            {
+                snprintf(buffer, sizeof(buffer), "Z80 Cycles: %llu  Instructions: %llu",
+                         static_cast<unsigned long long>(emuStats->cycles),
+                         static_cast<unsigned long long>(emuStats->instructions));
+                debugLines.push_back(buffer);
+
+                const auto &interrupts = augmentinel->GetInterruptScheduler();
+                snprintf(buffer, sizeof(buffer), "Interrupts: %u  Pending: %d  Deferred: %u  Dropped: %u",
+                         emuStats->interrupts, interrupts.Pending(),
+                         interrupts.DeferredCount(), interrupts.DroppedCount());
+                debugLines.push_back(buffer);
+
+                auto pointerTests = augmentinel->GetPointerCacheTests();
+                snprintf(buffer, sizeof(buffer), "Pointer Ray Cache: %.1f%% hit (%u/%u)",
+                         pointerTests ? 100.0f * augmentinel->GetPointerCacheHits() / pointerTests : 0.0f,
+                         augmentinel->GetPointerCacheHits(), pointerTests);
+                debugLines.push_back(buffer);
+
+                if (interrupts.IsTurbo())
+                {
+                    snprintf(buffer, sizeof(buffer), "Turbo: x%d", interrupts.Turbo());
+                    debugLines.push_back(buffer);
+                }
+
+                for (size_t i = 0; i < emuStats->hook_count; ++i)
+                {
+                    auto &hook = emuStats->hook_hits[i];
+                    if (hook.hits)
+                    {
+                        snprintf(buffer, sizeof(buffer), "  Hook %04X: %u", hook.address, hook.hits);
+                        debugLines.push_back(buffer);
+                    }
+                }
+            }
+
             m_pDebugOverlay->SetText(debugLines);
         }
 
         // Update game
         if (m_pGame)
         {
-            m_pGame->Frame(elapsed);
+            if (auto *augmentinel = dynamic_cast<Augmentinel *>(m_pGame.get()))
+                augmentinel->ResetEmulationStats();
+            if (m_pJobs)
+                m_pJobs->ResetStats();
+            Model::ResetMatrixRecomputeCount();
+
+            auto gameStart = std::chrono::high_resolution_clock::now();
+            {
+                AllocScope allocScope("Game Frame");
+                m_pGame->Frame(elapsed);
+            }
+            m_gameTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - gameStart).count();
 
             // Check if game wants to quit (e.g., from title screen)
             if (m_pGame->WantsToQuit())
@@ -258,15 +377,29 @@ void Application::Run(bool dumpScreenshot)
             m_pRenderer->ProcessKeyEdges();
         }
 
+        // Throttle rendering while fast-forwarding, leaving the time for emulation
+        auto *augmentinel = dynamic_cast<Augmentinel *>(m_pGame.get());
+        if (augmentinel && augmentinel->GetInterruptScheduler().IsTurbo() && !dumpScreenshot &&
+            std::chrono::duration<float>(currentTime - lastRenderTime).count() < TURBO_RENDER_INTERVAL)
+        {
+            SDL_Delay(1);
+            continue;
+        }
+        lastRenderTime = currentTime;
+        m_fpsFrameCount++;
+
         // Render
         if (m_pRenderer)
         {
+            auto renderStart = std::chrono::high_resolution_clock::now();
+            AllocScope allocScope("Render");
             m_pRenderer->BeginScene();
             if (m_pGame)
             {
                 m_pRenderer->Render(m_pGame.get());
             }
             m_pRenderer->EndScene();
+            m_renderTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - renderStart).count();
         }
 
         // Render debug overlay on top of everything
@@ -483,6 +616,10 @@ void Application::Shutdown()
     m_pGame.reset();
     m_pAudio.reset();
     m_pRenderer.reset();
+    m_pJobs.reset();
+    m_pFrameArena.reset();
+
+    AllocTracker::Report();
 
     if (m_glContext)
     {
@@ -4,12 +4,16 @@
 #include "Audio.h"
 #include "View.h"
 #include "DebugOverlay.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
 
 class Application {
 public:
     Application();
     ~Application();
 
+    static void InitPaths();
+
     bool Init();
     void Run(bool dumpScreenshot = false);
     void Shutdown();
@@ -22,6 +26,8 @@ private:
     SDL_Window* m_window{nullptr};
     SDL_GLContext m_glContext{nullptr};
 
+    std::unique_ptr<JobSystem> m_pJobs;
+    std::unique_ptr<FrameArena> m_pFrameArena;
     std::shared_ptr<View> m_pRenderer;
     std::shared_ptr<Audio> m_pAudio;
     std::unique_ptr<Game> m_pGame;
@@ -38,6 +44,8 @@ private:
     uint32_t m_fpsLastTime{0};
     float m_currentFPS{0.0f};
     float m_avgFrameTime{0.0f};
+    float m_gameTime{0.0f};      // Game::Frame time last frame, in ms (includes emulation)
+    float m_renderTime{0.0f};    // Scene render time last frame, in ms
 
     // Fullscreen toggle
     bool m_fullscreen{false};
@@ -10,21 +10,27 @@ constexpr auto SENTINEL_TURN_TIME = 0.25f;	 // 0.25 second animation time for tu
 constexpr auto DISSOLVE_TIME = 1.4f;				 // Dissolve time for created or absorbed objects
 constexpr auto SEEN_FRAME_THRESHOLD = 2;		 // Number of frames before trusting seen state.
 constexpr auto PAGE_STEPS = 10;							 // Page Up/Down steps for entire landscape list.
+constexpr auto MAX_FILTER_SENTRIES = 7;			 // highest sentry count in the landscape filter cycle.
+constexpr auto GRID_COLUMNS = 5;						 // landscape grid browser columns.
+constexpr auto GRID_ROWS = 4;								 // landscape grid browser rows.
+constexpr auto GRID_PAGE_SIZE = GRID_COLUMNS * GRID_ROWS;
+constexpr auto GRID_CELL_MARGIN = 0.05f;		 // gap around each grid thumbnail, as a fraction of its size.
 constexpr auto DEFAULT_MOUSE_SPEED = 70;		 // default mouse move sensitivity.
 constexpr auto HYPERSPACE_ANGLE = 60;				 // a transfer to sky at >=60 degrees for hyperspace.
 constexpr auto SKY_VIEW_ANGLE = 10;					 // placing a robot in the sky at >=10 degrees is sky view.
 constexpr auto SKY_VIEW_DISTANCE = 60.0f;		 // view distance from player in sky view.
 constexpr auto SKY_VIEW_DISTANCE_VR = 30.0f; // sky view distance in VR mode (lower, due to higher FOV).
 constexpr auto SEEN_HAPTIC_FREQ = 0.1f;			 // seconds between haptic pulses when seen.
-constexpr auto TILE_AXIS_SAMPLES = 5;				 // tile visibility hit test samples per axis.
 constexpr auto VOLUME_STEP = 10;						 // volume adjustment step percentage.
 constexpr auto POINTER_SCALE = 4;						 // 3D pointer block scale.
-constexpr auto TEMP_ID_BASE = 0x100;				 // Base id for temporary model.
+constexpr auto POINTER_CACHE_EPSILON = 1e-5f; // pointer ray movement that forces a new ray test.
+constexpr size_t MIN_BATCHED_VERTEX_RAYS = 128; // smaller models test vertex rays serially, stopping at the first visible.
 
 constexpr auto SENTINEL_SNAPSHOT_FILE = L"sentinel.sna";
 
 static const auto LANDSCAPES_SECTION{L"Landscapes"};
 static const auto LAST_LANDSCAPE_KEY{L"LastLandscape"};
+static const auto LANDSCAPE_FILTER_KEY{L"LandscapeFilter"};
 static const auto MOUSE_SPEED_KEY{L"MouseSpeed"};
 static const auto SOUND_PACK_KEY{L"SoundPack"};
 static const auto GAME_SPEED_KEY{L"GameSpeed"};
@@ -74,6 +80,9 @@ static std::vector<ActionBinding> action_bindings =
 				{Action::LandscapeLast, {VK_END}, "/actions/game/in/landscape_last"},
 				{Action::LandscapePgUp, {VK_PRIOR}, "/actions/game/in/landscape_pgup"},
 				{Action::LandscapePgDn, {VK_NEXT}, "/actions/game/in/landscape_pgdn"},
+				{Action::LandscapeFilter, {VK_F}, nullptr},
+				{Action::LandscapeGrid, {VK_G}, nullptr},
+				{Action::Turbo, {VK_Z}, nullptr},
 				{Action::Quit, {VK_ESCAPE}, "/actions/game/in/quit"},
 				{Action::Pause, {VK_P, VK_PAUSE}, "/actions/game/in/pause"},
 				{Action::Absorb, {VK_A, VK_LBUTTON}, "/actions/game/in/select"},
@@ -113,12 +122,48 @@ std::vector<std::pair<int, std::wstring>> game_speeds{
 		{200, L"Very Hard  (6 seconds)"},
 };
 
+// Fast-forward factors cycled by the turbo key.
+static const std::vector<int> turbo_factors{1, 10, 25, 50};
+
 std::vector<std::pair<int, std::wstring>> msaa_modes{
 		{1, L"Off"},
 		{2, L"2x"},
 		{4, L"4x"},
 };
 
+// Remove trees and double size of humanoids, for a clearer landscape preview.
+static void PreparePreviewModels(std::vector<Model> &models)
+{
+	for (auto it = models.begin(); it != models.end();)
+	{
+		auto &model = *it;
+		switch (model.type)
+		{
+		case ModelType::Sentinel:
+		case ModelType::Sentry:
+		case ModelType::Robot:
+			model.scale = 2.0f;				 // double model size
+			model.pos.y += EYE_HEIGHT; // raise scaled model standing position
+			break;
+		case ModelType::Tree:
+			it = models.erase(it);
+			continue;
+		default:
+			break;
+		}
+		++it;
+	}
+}
+
+// Flat view camera used for the landscape preview and its thumbnails.
+static Camera PreviewCamera()
+{
+	Camera camera;
+	camera.SetPosition({15.0f, 30.5f, -57.0f});
+	camera.SetRotation({PitchToRadians(0xea), YawToRadians(0x00), 0.0f});
+	return camera;
+}
+
 Augmentinel::Augmentinel(std::shared_ptr<View> &pView, std::shared_ptr<Audio> &pAudio)
 		: m_pView(pView), m_pAudio(pAudio)
 {
@@ -165,8 +210,10 @@ Augmentinel::Augmentinel(std::shared_ptr<View> &pView, std::shared_ptr<Audio> &p
 
 	// Calculate the frame time to give the requested running speed.
 	m_frame_time = 100.0f / game_speed / SPECTRUM_FRAMES_PER_SECOND;
+	m_interrupts.SetPeriod(m_frame_time);
 
 	LoadLandscapeCodes();
+	m_landscape_index.Load(LandscapeIndex::DefaultPath());
 	ChangeState(GameState::Reset);
 }
 
@@ -305,16 +352,10 @@ void Augmentinel::Render(IScene *pScene)
 	if (m_landscape)
 		pScene->DrawModel(m_landscape);
 
-	// Draw any models placed on the landscape.
-	for (auto &model : m_drawn_models)
-	{
-		// Don't draw the player model (except in sky view) as it blocks our view.
-		if (m_player && model.id == m_player.id && m_state != GameState::SkyView)
-			continue;
-
-		// Draw models relative to the landscape.
-		pScene->DrawModel(model, m_landscape);
-	}
+	// Draw any models placed on the landscape, relative to it. Don't draw the
+	// player model (except in sky view) as it blocks our view.
+	auto hidden_id = (m_player && m_state != GameState::SkyView) ? m_player.id : -1;
+	pScene->DrawModels(m_drawn_models.Models(), m_landscape, hidden_id);
 
 	// Landscape title text.
 	for (auto &letter : m_text)
@@ -323,6 +364,12 @@ void Augmentinel::Render(IScene *pScene)
 	if (m_skybox)
 		pScene->DrawModel(m_skybox);
 
+	if (m_state == GameState::LandscapePreview && m_grid_view)
+		DrawLandscapeGrid();
+
+	// Allow each coalesced fast-forward sound to play again next frame.
+	m_turbo_sounds.clear();
+
 	// Show aiming pointer only in game mode.
 	if (m_state == GameState::Game)
 	{
@@ -331,12 +378,12 @@ void Augmentinel::Render(IScene *pScene)
 		m_pView->GetSelectionRay(vRayPos, vRayDir);
 
 		RayTarget hit;
-		if (SceneRayTest(vRayPos, vRayDir, hit, m_player.id))
+		if (PointerRayTest(vRayPos, vRayDir, hit))
 		{
 			distance = hit.distance;
 
 			// Transform model surface normal to a world direction vector.
-			auto normal = (*hit.model->m_pVertices)[(*hit.model->m_pIndices)[hit.index]].normal;
+			auto normal = hit.model->m_pMesh->Vertices()[hit.model->m_pMesh->Indices()[hit.index]].normal;
 			vNormal = XMVector4Transform(XMLoadFloat3(&normal), hit.model->GetWorldMatrix());
 		}
 		else
@@ -378,8 +425,10 @@ void Augmentinel::Frame(float fElapsed)
 	// Update music state and process music keys.
 	PlayMusic();
 
-	// Animate models before any processing.
-	AnimateModels(m_animations, fElapsed, this);
+	// Animate models before any processing, faster when fast-forwarding.
+	if (!m_animations.empty())
+		++m_scene_version;
+	AnimateModels(m_animations, fElapsed * m_interrupts.Turbo(), this);
 
 	// Poll the state of all action bindings (VR only).
 	m_pView->PollInputBindings(action_bindings);
@@ -399,7 +448,7 @@ void Augmentinel::Frame(float fElapsed)
 		m_pView->SetVerticalFOV(SENTINEL_VERT_FOV);
 
 		m_animations = {};
-		m_landscape = {};
+		KeepLandscape();
 		m_player = {};
 		m_skybox = {};
 		m_text = {};
@@ -437,7 +486,7 @@ void Augmentinel::Frame(float fElapsed)
 			}
 
 			// Extract  text as models.
-			m_drawn_models = m_spectrum->ExtractText(); // "THE SENTINEL"
+			m_drawn_models = ModelSlotMap(m_spectrum->ExtractText()); // "THE SENTINEL"
 
 			m_pView->EnableFreeLook(false);
 			m_pView->SetCameraPosition({-11.63f, 57.8f, -61.5f});
@@ -450,12 +499,12 @@ void Augmentinel::Frame(float fElapsed)
 			auto sentinel = m_spectrum->GetModel(ModelType::Sentinel);
 			sentinel.pos = {-8.31f, 54.06f, -57.11f};
 			sentinel.rot = {-0.47f, 4.16f, -0.31f};
-			m_drawn_models.push_back(std::move(sentinel));
+			m_drawn_models.Add(std::move(sentinel));
 
 			auto pedestal = m_spectrum->GetModel(ModelType::Pedestal);
 			pedestal.pos = {-8.5f, 53.19f, -57.58f};
 			pedestal.rot = {-0.47f, 4.16f, -0.31f};
-			m_drawn_models.push_back(std::move(pedestal));
+			m_drawn_models.Add(std::move(pedestal));
 
 			m_pView->SetEffect(ViewEffect::Fade, 0.0f);
 
@@ -500,29 +549,24 @@ void Augmentinel::Frame(float fElapsed)
 		{
 			m_rotate_landscape = GetFlag(L"RotateLandscape", m_rotate_landscape);
 
-			m_landscape = m_spectrum->ExtractLandscape();
-			m_drawn_models = m_spectrum->ExtractPlacedModels();
-
-			// Remove trees and double size of humanoids.
-			for (auto it = m_drawn_models.begin(); it != m_drawn_models.end();)
+			// Patch the previous landscape mesh in place if we have one, to reuse its buffers.
+			if (m_spare_landscape.IsHeightfield())
 			{
-				auto &model = *it;
-				switch (model.type)
-				{
-				case ModelType::Sentinel:
-				case ModelType::Sentry:
-				case ModelType::Robot:
-					model.scale = 2.0f;				 // double model size
-					model.pos.y += EYE_HEIGHT; // raise scaled model standing position
-					break;
-				case ModelType::Tree:
-					it = m_drawn_models.erase(it);
-					continue;
-				default:
-					break;
-				}
-				++it;
+				auto pMesh = std::move(m_spare_landscape.m_pMesh);
+				m_spare_landscape = {};
+
+				m_landscape = Model{ pMesh, ModelType::Landscape };
+				m_landscape.pos.x = SENTINEL_MAP_SIZE / 2;
+				m_landscape.pos.z = SENTINEL_MAP_SIZE / 2;
+				pMesh.reset();
+				m_spectrum->UpdateLandscape(m_landscape);
 			}
+			else
+				m_landscape = m_spectrum->ExtractLandscape();
+
+			auto preview_models = m_spectrum->ExtractPlacedModels();
+			PreparePreviewModels(preview_models);
+			m_drawn_models = ModelSlotMap(std::move(preview_models));
 
 			m_text.clear();
 
@@ -551,22 +595,15 @@ void Augmentinel::Frame(float fElapsed)
 
 			SaveLastLandscape(m_landscape_bcd);
 
-			// Show the landscape number title text.
-			std::stringstream ss;
-			ss << "LANDSCAPE " << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << m_landscape_bcd;
-			AddText(ss.str(), 15.0f, 20.0f, -1.0f);
-
-			// Shown left arrow if there is a previous landscape in the unlocked list.
-			auto it_current = m_codes.find(m_landscape_bcd);
-			if (it_current != m_codes.begin())
-				AddText("<", 2.0f, 20.0f, -1.0f);
+			// Capture a grid thumbnail while we have the landscape geometry.
+			auto renderer = std::dynamic_pointer_cast<OpenGLRenderer>(m_pView);
+			if (renderer && !renderer->HasThumbnail(m_landscape_bcd))
+				renderer->RenderThumbnail(m_landscape_bcd, PreviewCamera(), m_landscape, m_drawn_models.Models(), m_spectrum->GetGamePalette());
 
-			// Shown right arrow if there is a next landscape in the unlocked list.
-			if (std::next(it_current) != m_codes.end())
-				AddText(">", 28.0f, 20.0f, -1.0f);
-
-			// If the player can see this they're facing the wrong way!
-			AddText("TURN AROUND", 15.0f, 20.0f, -60.0f, 14, true);
+			// Index the landscape we've just generated, and apply any browser filter.
+			m_landscape_index.Add(m_spectrum->GetLandscapeInfo());
+			UpdateLandscapeFilter();
+			AddPreviewText();
 
 			m_substate++;
 			break;
@@ -581,46 +618,88 @@ void Augmentinel::Frame(float fElapsed)
 			// Fade in landscape preview without delaying keyboard interaction.
 			m_pView->TransitionEffect(ViewEffect::Fade, 0.0f, fElapsed, 0.1f);
 
-			const auto it_current = m_codes.find(m_landscape_bcd);
-			auto it_new = it_current;
+			if (m_grid_view)
+			{
+				BrowseLandscapeGrid();
+				break;
+			}
+
+			// The current landscape may be excluded by the filter, so step from its position.
+			auto it_lower = m_browse_codes.lower_bound(m_landscape_bcd);
+			auto it_upper = m_browse_codes.upper_bound(m_landscape_bcd);
+			auto page_steps = m_browse_codes.size() / PAGE_STEPS;
+			auto new_landscape_bcd = m_landscape_bcd;
 
 			if (m_pView->InputAction(Action::LandscapePrev))
 			{
-				if (it_new != m_codes.begin())
-					it_new = std::prev(it_new);
+				if (it_lower != m_browse_codes.begin())
+					new_landscape_bcd = std::prev(it_lower)->first;
 			}
 			else if (m_pView->InputAction(Action::LandscapeNext))
 			{
-				if (std::next(it_new) != m_codes.end())
-					it_new = std::next(it_new);
+				if (it_upper != m_browse_codes.end())
+					new_landscape_bcd = it_upper->first;
 			}
 			else if (m_pView->InputAction(Action::LandscapePgUp))
 			{
-				for (size_t i = 0; i < m_codes.size() / PAGE_STEPS; ++i)
+				if (page_steps && it_lower != m_browse_codes.begin())
 				{
-					if (it_new != m_codes.begin())
+					auto it_new = std::prev(it_lower);
+					for (size_t i = 1; i < page_steps && it_new != m_browse_codes.begin(); ++i)
 						it_new = std::prev(it_new);
-					else
-						break;
+					new_landscape_bcd = it_new->first;
 				}
 			}
 			else if (m_pView->InputAction(Action::LandscapePgDn))
 			{
-				for (size_t i = 0; i < m_codes.size() / PAGE_STEPS; ++i)
+				if (page_steps && it_upper != m_browse_codes.end())
 				{
-					if (std::next(it_new) != m_codes.end())
+					auto it_new = it_upper;
+					for (size_t i = 1; i < page_steps && std::next(it_new) != m_browse_codes.end(); ++i)
 						it_new = std::next(it_new);
-					else
-						break;
+					new_landscape_bcd = it_new->first;
 				}
 			}
 			else if (m_pView->InputAction(Action::LandscapeFirst))
 			{
-				it_new = m_codes.begin();
+				if (!m_browse_codes.empty())
+					new_landscape_bcd = m_browse_codes.begin()->first;
 			}
 			else if (m_pView->InputAction(Action::LandscapeLast))
 			{
-				it_new = std::prev(m_codes.end());
+				if (!m_browse_codes.empty())
+					new_landscape_bcd = std::prev(m_browse_codes.end())->first;
+			}
+			else if (m_pView->InputAction(Action::LandscapeFilter))
+			{
+				// Cycle the sentry count filter: off, then 0 to MAX_FILTER_SENTRIES.
+				m_filter_sentries = (m_filter_sentries < MAX_FILTER_SENTRIES) ? m_filter_sentries + 1 : -1;
+				UpdateLandscapeFilter();
+
+				// Jump to the first match if the current landscape is now excluded,
+				// otherwise just refresh the preview text.
+				if (!m_browse_codes.empty() && !m_browse_codes.count(m_landscape_bcd))
+					new_landscape_bcd = m_browse_codes.begin()->first;
+				else
+				{
+					// Only the text changes, so release just the models being replaced.
+					auto renderer = std::dynamic_pointer_cast<OpenGLRenderer>(m_pView);
+					if (renderer)
+					{
+						for (auto &text : m_text)
+							renderer->ReleaseModel(text);
+					}
+
+					m_text.clear();
+					AddPreviewText();
+					break;
+				}
+			}
+			else if (m_pView->InputAction(Action::LandscapeGrid))
+			{
+				m_grid_view = true;
+				m_grid_landscape_bcd = m_landscape_bcd;
+				break;
 			}
 			else if (m_pView->InputAction(Action::Quit))
 			{
@@ -643,9 +722,9 @@ void Augmentinel::Frame(float fElapsed)
 				break;
 			}
 
-			if (it_new != it_current)
+			if (new_landscape_bcd != m_landscape_bcd)
 			{
-				m_landscape_bcd = it_new->first;
+				m_landscape_bcd = new_landscape_bcd;
 				ChangeState(GameState::Reset);
 			}
 			break;
@@ -676,10 +755,14 @@ void Augmentinel::Frame(float fElapsed)
 			m_pView->SetEffect(ViewEffect::Dissolve, 0.0f);
 			m_pView->SetEffect(ViewEffect::ZFade, 0.0f);
 
-			m_drawn_models = m_spectrum->ExtractPlacedModels();
+			m_drawn_models = ModelSlotMap(m_spectrum->ExtractPlacedModels());
 			m_player = m_spectrum->ExtractPlayerModel();
+			m_model_grid.Build(m_drawn_models.Models());
+			m_tile_visibility.Clear();
+			++m_scene_version;
 			m_animations.clear();
 			m_text.clear();
+			m_interrupts.Reset();
 
 			// Create a coloured skybox centred around the landscape.
 			m_skybox = Model::CreateBlock(200.0f, 200.0f, 200.0f, SKY_PALETTE_INDEX, ModelType::SkyBox);
@@ -741,6 +824,11 @@ void Augmentinel::Frame(float fElapsed)
 			{
 				m_pView->ResetHMD(true);
 			}
+			else if (m_pView->InputAction(Action::Turbo))
+			{
+				auto it = std::upper_bound(turbo_factors.begin(), turbo_factors.end(), m_interrupts.Turbo());
+				m_interrupts.SetTurbo((it != turbo_factors.end()) ? *it : turbo_factors.front());
+			}
 
 			float rot_x{0.0f}, rot_y{0.0f};
 
@@ -775,23 +863,24 @@ void Augmentinel::Frame(float fElapsed)
 			}
 
 			// Remove any objects that fade been faded out of existence.
-			m_drawn_models.erase(std::remove_if(m_drawn_models.begin(), m_drawn_models.end(), [](auto &m)
-																					{ return m.dissolved == 1.0f; }),
-													 m_drawn_models.end());
+			if (m_drawn_models.RemoveIf([](auto &m)
+																	{ return m.dissolved == 1.0f; }))
+				++m_scene_version;
 
 			// Run the Spectrum game if there are no active dissolve animations.
 			if (!PlayerAnimationActive())
 				m_spectrum->RunFrame(false);
 
-			static float total_elapsed = 0.0f;
-			total_elapsed += fElapsed;
-
 			// Run the Spectrum interrupt handler if it's due. This advances the Spectrum
-			// game timers used for various game events.
-			while (total_elapsed >= m_frame_time)
+			// game timers used for various game events. Any backlog after a slow frame
+			// is spread over the following frames, rather than run all at once.
+			for (auto n = m_interrupts.BeginFrame(fElapsed); n > 0 && m_state == GameState::Game; --n)
 			{
 				m_spectrum->RunInterrupt();
-				total_elapsed -= m_frame_time;
+
+				// When fast-forwarding, the game main loop also runs between interrupts.
+				if (n > 1 && m_interrupts.IsTurbo() && !PlayerAnimationActive())
+					m_spectrum->RunFrame(false);
 			}
 
 			// Require the seen state to persist for a certain number of
@@ -946,10 +1035,11 @@ void Augmentinel::Frame(float fElapsed)
 			if (!m_pView->TransitionEffect(effect, 1.0f, fElapsed, 3.0f))
 				break;
 
-			m_landscape = {};
+			KeepLandscape();
 			m_skybox = {};
 
-			m_drawn_models = {m_spectrum->GetModel(1, true)};
+			m_drawn_models.Clear();
+			m_drawn_models.Add(m_spectrum->GetModel(1, true));
 			m_player = m_spectrum->GetModel(2, true);
 
 			m_pView->SetCameraPosition(m_player.pos);
@@ -1057,22 +1147,37 @@ void Augmentinel::AddText(const std::string &str, float x_centre, float y, float
 	auto x = x_centre - (x_sign * str_size / 2.0f);
 	auto yaw = reversed ? XM_PI : 0.0f;
 
-	for (auto ch : str)
-	{
-		if (ch != ' ')
-		{
-			if (ch == '0')
-				ch = 'O';
-
-			auto model = m_spectrum->CharToModel(ch, colour);
-			model.pos = {x, y, z};
-			model.rot.y = yaw;
-			model.scale = scale;
-			m_text.push_back(std::move(model));
-		}
+	auto text = str;
+	std::replace(text.begin(), text.end(), '0', 'O');
 
-		x += spacing * x_sign;
-	}
+	// One model for the whole string, with the letter spacing baked into the mesh.
+	// Rotating for reversed text also flips the spacing direction.
+	auto model = m_spectrum->TextToModel(text, colour, spacing / scale);
+	if (!model)
+		return;
+
+	model.pos = {x, y, z};
+	model.rot.y = yaw;
+	model.scale = scale;
+	m_text.push_back(std::move(model));
+}
+
+void Augmentinel::AddAnimation(const Animation &animation)
+{
+	// Fast-forwarding coalesces animations into their end state.
+	if (m_interrupts.IsTurbo())
+		FinishAnimation(animation, this);
+	else
+		m_animations.push_back(animation);
+}
+
+void Augmentinel::PlayEffect(const std::wstring &filename, XMFLOAT3 pos)
+{
+	// Fast-forwarding plays each effect at most once per rendered frame.
+	if (m_interrupts.IsTurbo() && !m_turbo_sounds.insert(filename).second)
+		return;
+
+	m_pAudio->Play(filename, AudioType::Effect, pos);
 }
 
 bool Augmentinel::PlayerAnimationActive() const
@@ -1156,30 +1261,259 @@ void Augmentinel::RemoveLandscapeCode(int landscape_bcd)
 	RemoveSetting(ss_landscape.str(), LANDSCAPES_SECTION);
 }
 
-bool Augmentinel::SceneRayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget &hit, int ignore_id)
+// Text shown around the landscape preview, which depends on the browser filter.
+void Augmentinel::AddPreviewText()
+{
+	// Show the landscape number title text.
+	std::stringstream ss;
+	ss << "LANDSCAPE " << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << m_landscape_bcd;
+	AddText(ss.str(), 15.0f, 20.0f, -1.0f);
+
+	if (m_filter_sentries >= 0)
+	{
+		std::stringstream ss_filter;
+		ss_filter << "FILTER " << m_filter_sentries << " SENTRIES";
+		AddText(ss_filter.str(), 15.0f, 17.5f, -1.0f, m_browse_codes.empty() ? 2 : 1);
+	}
+
+	// Shown left arrow if there is a previous landscape in the unlocked list.
+	if (m_browse_codes.lower_bound(m_landscape_bcd) != m_browse_codes.begin())
+		AddText("<", 2.0f, 20.0f, -1.0f);
+
+	// Shown right arrow if there is a next landscape in the unlocked list.
+	if (m_browse_codes.upper_bound(m_landscape_bcd) != m_browse_codes.end())
+		AddText(">", 28.0f, 20.0f, -1.0f);
+
+	// If the player can see this they're facing the wrong way!
+	AddText("TURN AROUND", 15.0f, 20.0f, -60.0f, 14, true);
+}
+
+void Augmentinel::UpdateLandscapeFilter()
 {
-	std::map<float, RayTarget> hits;
+	// Combine any custom query from the settings file with the sentry count filter.
+	auto query = to_string(GetSetting(LANDSCAPE_FILTER_KEY, L""));
+	if (m_filter_sentries >= 0)
+		query += " sentries=" + std::to_string(m_filter_sentries);
 
-	if (m_landscape.RayTest(vRayPos, vRayDir, hit))
-		hits[hit.distance] = hit;
+	m_browse_codes = m_codes;
+	if (query.find_first_not_of(' ') == std::string::npos)
+		return;
 
-	for (auto &model : m_drawn_models)
+	std::set<int> matches;
+	try
 	{
-		if (model.id >= TEMP_ID_BASE || ignore_id >= 0 && model.id == ignore_id)
-			continue;
+		for (auto info : m_landscape_index.Query(query))
+			matches.insert(info->landscape_bcd);
+	}
+	catch (const std::exception &)
+	{
+		// Ignore an invalid custom query, rather than hiding every landscape.
+		return;
+	}
+
+	// Keep only unlocked landscapes that are indexed and match the filter.
+	for (auto it = m_browse_codes.begin(); it != m_browse_codes.end();)
+	{
+		if (matches.count(it->first))
+			++it;
+		else
+			it = m_browse_codes.erase(it);
+	}
+}
+
+int Augmentinel::GetGridIndex() const
+{
+	// The grid landscape may be excluded by the filter, so use the nearest.
+	auto it = m_browse_codes.lower_bound(m_grid_landscape_bcd);
+	if (it == m_browse_codes.end() && it != m_browse_codes.begin())
+		--it;
+
+	return static_cast<int>(std::distance(m_browse_codes.begin(), it));
+}
+
+void Augmentinel::BrowseLandscapeGrid()
+{
+	UpdateThumbnails();
+
+	auto count = static_cast<int>(m_browse_codes.size());
+	auto index = GetGridIndex();
+	auto new_index = index;
+
+	if (m_pView->InputAction(Action::LandscapePrev))
+		new_index = index - 1;
+	else if (m_pView->InputAction(Action::LandscapeNext))
+		new_index = index + 1;
+	else if (m_pView->InputAction(Action::LookUp))
+		new_index = (index >= GRID_COLUMNS) ? index - GRID_COLUMNS : index;
+	else if (m_pView->InputAction(Action::LookDown))
+		new_index = (index + GRID_COLUMNS < count) ? index + GRID_COLUMNS : index;
+	else if (m_pView->InputAction(Action::LandscapePgUp))
+		new_index = index - GRID_PAGE_SIZE;
+	else if (m_pView->InputAction(Action::LandscapePgDn))
+		new_index = index + GRID_PAGE_SIZE;
+	else if (m_pView->InputAction(Action::LandscapeFirst))
+		new_index = 0;
+	else if (m_pView->InputAction(Action::LandscapeLast))
+		new_index = count - 1;
+	else if (m_pView->InputAction(Action::LandscapeGrid) || m_pView->InputAction(Action::Quit))
+		m_grid_view = false;
+	else if (m_pView->InputAction(Action::LandscapeSelect))
+	{
+		m_grid_view = false;
+
+		// Only the chosen landscape needs a full reset and regeneration.
+		auto selected_bcd = count ? std::next(m_browse_codes.begin(), index)->first : m_landscape_bcd;
+		if (selected_bcd != m_landscape_bcd)
+		{
+			m_landscape_bcd = selected_bcd;
+			ChangeState(GameState::Reset);
+		}
+		return;
+	}
+
+	if (count)
+	{
+		new_index = std::min(std::max(new_index, 0), count - 1);
+		m_grid_landscape_bcd = std::next(m_browse_codes.begin(), new_index)->first;
+	}
+}
+
+void Augmentinel::UpdateThumbnails()
+{
+	auto renderer = std::dynamic_pointer_cast<OpenGLRenderer>(m_pView);
+	if (!renderer)
+		return;
+
+	// Render the thumbnail once its landscape has been generated in the background.
+	if (m_thumbnail_bcd >= 0)
+	{
+		if (!m_thumbnail_task.IsDone())
+			return;
+
+		auto &geometry = m_thumbnail_geometry;
+		if (geometry.landscape)
+		{
+			PreparePreviewModels(geometry.models);
+			m_landscape_index.Add(geometry.info);
+			renderer->RenderThumbnail(geometry.info.landscape_bcd, PreviewCamera(), geometry.landscape, geometry.models, geometry.palette);
+
+			// The generated geometry is discarded now, so don't leave it in the model
+			// cache where a recycled address could find it. Interned meshes stay cached.
+			renderer->ReleaseModel(geometry.landscape);
+			for (auto &model : geometry.models)
+			{
+				if (!model.m_pMesh.IsShared())
+					renderer->ReleaseModel(model);
+			}
+		}
+		else
+		{
+			// Leave a placeholder rather than retrying a landscape that won't generate.
+			m_thumbnail_failed.insert(m_thumbnail_bcd);
+		}
+
+		m_thumbnail_geometry = {};
+		m_thumbnail_bcd = -1;
+	}
+
+	// Start generating the first missing thumbnail on the visible page.
+	auto page_start = GetGridIndex() / GRID_PAGE_SIZE * GRID_PAGE_SIZE;
+	auto it = std::next(m_browse_codes.begin(), std::min(page_start, static_cast<int>(m_browse_codes.size())));
+	for (auto i = 0; i < GRID_PAGE_SIZE && it != m_browse_codes.end(); ++i, ++it)
+	{
+		if (!m_thumbnail_failed.count(it->first) && !renderer->HasThumbnail(it->first))
+		{
+			m_thumbnail_bcd = it->first;
+			m_thumbnail_task.RunBackground([this, landscape_bcd = it->first]
+																		 {
+																			 // A landscape that fails to generate is left as empty geometry.
+																			 try
+																			 {
+																				 m_thumbnail_geometry = LandscapeIndex::GenerateGeometry(landscape_bcd);
+																			 }
+																			 catch (const std::exception &)
+																			 {
+																			 }
+																		 });
+			break;
+		}
+	}
+}
+
+void Augmentinel::DrawLandscapeGrid()
+{
+	auto renderer = std::dynamic_pointer_cast<OpenGLRenderer>(m_pView);
+	if (!renderer || m_browse_codes.empty())
+		return;
+
+	auto width = static_cast<float>(m_pView->GetWidth());
+	auto height = static_cast<float>(m_pView->GetHeight());
+	auto aspect = renderer->GetThumbnailAspectRatio();
+
+	// Fit the grid to the window, keeping the thumbnail aspect ratio.
+	auto cell_width = std::min(width / GRID_COLUMNS, height / GRID_ROWS * aspect);
+	auto cell_height = cell_width / aspect;
+	auto x_start = (width - cell_width * GRID_COLUMNS) / 2.0f;
+	auto y_start = (height - cell_height * GRID_ROWS) / 2.0f;
+	auto x_margin = cell_width * GRID_CELL_MARGIN;
+	auto y_margin = cell_height * GRID_CELL_MARGIN;
+
+	auto index = GetGridIndex();
+	auto page_start = index / GRID_PAGE_SIZE * GRID_PAGE_SIZE;
+	auto it = std::next(m_browse_codes.begin(), page_start);
+	for (auto i = 0; i < GRID_PAGE_SIZE && it != m_browse_codes.end(); ++i, ++it)
+	{
+		auto x = x_start + (i % GRID_COLUMNS) * cell_width + x_margin;
+		auto y = y_start + (i / GRID_COLUMNS) * cell_height + y_margin;
 
-		if (model.RayTest(vRayPos, vRayDir, hit))
-			hits[hit.distance] = hit;
+		renderer->DrawThumbnail(it->first,
+														x / width, y / height,
+														(cell_width - x_margin * 2.0f) / width, (cell_height - y_margin * 2.0f) / height,
+														page_start + i == index);
 	}
+}
+
+bool Augmentinel::SceneRayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget &hit, int ignore_id)
+{
+	auto landscape_hit = m_landscape.RayTest(vRayPos, vRayDir, hit);
 
-	if (!hits.empty())
+	// Models only need testing up to the landscape hit, and win a tie with it.
+	RayTarget model_hit;
+	auto max_distance = landscape_hit ? hit.distance : FLT_MAX;
+	if (m_model_grid.RayTest(vRayPos, vRayDir, this, model_hit, ignore_id, max_distance) &&
+			(!landscape_hit || model_hit.distance <= hit.distance))
 	{
-		// First item is closest, due to map key (distance) sorting.
-		hit = hits.begin()->second;
+		hit = model_hit;
 		return true;
 	}
 
-	return false;
+	return landscape_hit;
+}
+
+bool Augmentinel::PointerRayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget &hit)
+{
+	auto &cache = m_pointer_cache;
+	++cache.tests;
+
+	// Reuse the previous result if the ray has barely moved and nothing in the scene has changed.
+	if (cache.valid && cache.scene_version == m_scene_version && cache.ignore_id == m_player.id &&
+			XMVector3NearEqual(vRayPos, XMLoadFloat3(&cache.pos), XMVectorReplicate(POINTER_CACHE_EPSILON)) &&
+			XMVector3NearEqual(vRayDir, XMLoadFloat3(&cache.dir), XMVectorReplicate(POINTER_CACHE_EPSILON)))
+	{
+		++cache.hits;
+		hit = cache.hit;
+		return cache.is_hit;
+	}
+
+	cache.is_hit = SceneRayTest(vRayPos, vRayDir, cache.hit, m_player.id);
+	XMStoreFloat3(&cache.pos, vRayPos);
+	XMStoreFloat3(&cache.dir, vRayDir);
+	cache.ignore_id = m_player.id;
+	cache.scene_version = m_scene_version;
+	cache.valid = true;
+
+	hit = cache.hit;
+	return cache.is_hit;
 }
 
 bool Augmentinel::SceneModelVisible(const XMVECTOR vRayPos, const Model &model, int ignore_id)
@@ -1191,7 +1525,7 @@ bool Augmentinel::SceneModelVisible(const XMVECTOR vRayPos, const Model &model,
 		uint32_t index;
 	};
 
-	std::vector<CornerRay> corner_rays;
+	FrameVector<CornerRay> corner_rays;
 
 	// Cast rays from the camera to each vertex of the bounding box.
 	for (auto &corner : model.GetBoundingBox())
@@ -1217,7 +1551,7 @@ bool Augmentinel::SceneModelVisible(const XMVECTOR vRayPos, const Model &model,
 	if (corner_rays.empty())
 		return false;
 
-	std::set<Model *> ray_hits;
+	FrameSet<Model *> ray_hits;
 	for (auto &m : m_drawn_models)
 	{
 		// Ignore the model we're testing against, and any supplied id.
@@ -1241,101 +1575,87 @@ bool Augmentinel::SceneModelVisible(const XMVECTOR vRayPos, const Model &model,
 
 	auto mModelWorld = model.GetWorldMatrix();
 
-	// Test the visibility of each vertex in the target model.
-	for (auto &vertex : *(model.m_pVertices))
-	{
-		XMVECTOR vVertex{vertex.pos.x, vertex.pos.y, vertex.pos.z, 1.0f};
-		auto vVertexWorld = XMVector4Transform(vVertex, mModelWorld);
-
-		auto vRayVertex = vVertexWorld - vRayPos;
-		auto vRayDir = XMVector3Normalize(vRayVertex);
-
-		float vertex_dist{};
-		XMStoreFloat(&vertex_dist, XMVector3Length(vRayVertex));
-
-		float closest_dist{vertex_dist};
-		RayTarget hit;
+	// Threads only read the cached model matrices, so bring them up to date first.
+	m_landscape.UpdateMatrices();
+	for (auto pModel : ray_hits)
+		pModel->UpdateMatrices();
 
-		// Detailed test against each tile in the landscape.
-		if (m_landscape.RayTest(vRayPos, vRayDir, hit))
-			closest_dist = std::min(hit.distance, closest_dist);
+	// Detailed test against the landscape, and any models that may obscure the target.
+	auto ray_test = [&](XMVECTOR vTestRayPos, XMVECTOR vTestRayDir, RayTarget &hit)
+	{
+		auto found = m_landscape.RayTest(vTestRayPos, vTestRayDir, hit);
 
-		// Detailed test against any models that may obscure the target.
+		RayTarget model_hit;
 		for (auto pModel : ray_hits)
 		{
-			if (pModel->RayTest(vRayPos, vRayDir, hit))
-				closest_dist = std::min(hit.distance, closest_dist);
+			if (pModel->RayTest(vTestRayPos, vTestRayDir, model_hit) && (!found || model_hit.distance < hit.distance))
+			{
+				hit = model_hit;
+				found = true;
+			}
 		}
 
-		// If a ray reached the target vertex the model is visible.
-		if (closest_dist >= vertex_dist)
-			return true;
-	}
-
-	return false;
-}
+		return found;
+	};
 
-bool Augmentinel::SceneTileVisible(const XMVECTOR vRayPos, int tile_x, int tile_z)
-{
-	auto world_corners = m_landscape.GetTileCorners(tile_x, tile_z);
+	auto &vertices = model.m_pMesh->Vertices();
+	auto batched = vertices.size() >= MIN_BATCHED_VERTEX_RAYS;
 
-	XMFLOAT3 eye_pos{};
-	XMStoreFloat3(&eye_pos, vRayPos);
+	RayBatch vertex_rays;
+	FrameVector<float> vertex_dists;
 
-	std::array<XMFLOAT3, 4> corner_pos;
-	for (size_t i = 0; i < world_corners.size(); ++i)
+	// Cast a ray to each vertex in the target model.
+	for (auto &vertex : vertices)
 	{
-		XMStoreFloat3(&corner_pos[i], world_corners[i]);
+		XMVECTOR vVertex{vertex.pos.x, vertex.pos.y, vertex.pos.z, 1.0f};
+		auto vVertexWorld = XMVector4Transform(vVertex, mModelWorld);
 
-		// Reject non-flat tiles, and those at/above eye height.
-		if (corner_pos[i].y != corner_pos[0].y || corner_pos[i].y >= eye_pos.y)
-			return false;
-	}
+		auto vRayVertex = vVertexWorld - vRayPos;
+		auto vRayDir = XMVector3Normalize(vRayVertex);
 
-	constexpr auto NUM_GRID_VERTICES = TILE_AXIS_SAMPLES * TILE_AXIS_SAMPLES;
-	std::array<XMVECTOR, NUM_GRID_VERTICES> grid_vertices{};
+		float vertex_dist{};
+		XMStoreFloat(&vertex_dist, XMVector3Length(vRayVertex));
 
-	// Scan across the tile surface in a grid pattern.
-	for (int z = 0; z < TILE_AXIS_SAMPLES; ++z)
-	{
-		for (int x = 0; x < TILE_AXIS_SAMPLES; ++x)
+		if (batched)
 		{
-			constexpr auto step = 1.0f / (TILE_AXIS_SAMPLES - 1);
-			auto idx = (z * TILE_AXIS_SAMPLES) + x;
-
-			const auto &[min_x, y, min_z] = corner_pos[0];
-			grid_vertices[idx] = {min_x + step * x, y, min_z + step * z, 1.0f};
+			vertex_rays.Add(vRayPos, vRayDir);
+			vertex_dists.push_back(vertex_dist);
+			continue;
 		}
+
+		// Small models stop at the first vertex a ray reaches.
+		RayTarget hit;
+		if (!ray_test(vRayPos, vRayDir, hit) || hit.distance >= vertex_dist)
+			return true;
 	}
 
-	// Cast rays from the camera to each grid position on the tile.
-	for (auto &v : grid_vertices)
-	{
-		// Calculate the vector to the corner vertex in world space, and its unit direction vector.
-		auto vRay = v - vRayPos;
-		auto vRayDir = XMVector3Normalize(vRay);
+	if (!batched)
+		return false;
 
-		// Calculate the distance from camera to corner.
-		float vertex_dist;
-		XMStoreFloat(&vertex_dist, XMVector3Length(vRay));
+	vertex_rays.Run(ray_test);
 
-		// It's visible if we don't hit another part of the landscape before the tile corner,
-		// even if we miss the corner due to floating point precision errors.
-		RayTarget hit;
-		if (!m_landscape.RayTest(vRayPos, vRayDir, hit) || hit.distance > (vertex_dist - 0.001f))
+	// If a ray reached the target vertex the model is visible.
+	for (size_t i = 0; i < vertex_rays.Size(); ++i)
+	{
+		if (!vertex_rays.IsHit(i) || vertex_rays.GetHit(i).distance >= vertex_dists[i])
 			return true;
 	}
 
-	// Tile not visible.
 	return false;
 }
 
-Model *Augmentinel::FindModelById(int id)
+bool Augmentinel::SceneTileVisible(const XMVECTOR vRayPos, int tile_x, int tile_z)
 {
-	auto it = std::find_if(m_drawn_models.begin(), m_drawn_models.end(), [&](auto &m)
-												 { return m.id == id; });
+	// Every tile is tested at once, and reused until the eye position changes.
+	if (!m_tile_visibility.IsBuilt(m_landscape, vRayPos))
+		m_tile_visibility.Build(m_landscape, vRayPos);
+
+	return m_tile_visibility.IsVisible(tile_x, tile_z);
+}
 
-	return (it != m_drawn_models.end()) ? &(*it) : nullptr;
+Model *Augmentinel::FindModelById(int id)
+{
+	return m_drawn_models.Find(id);
 }
 
 std::vector<Model> Augmentinel::GetModelStack(int tile_x, int tile_z)
@@ -1344,7 +1664,7 @@ std::vector<Model> Augmentinel::GetModelStack(int tile_x, int tile_z)
 
 	std::copy_if(m_drawn_models.begin(), m_drawn_models.end(),
 							 std::back_inserter(models), [&](auto &m)
-							 { return m.id < TEMP_ID_BASE &&
+							 { return m.id < ModelSlotMap::TEMP_ID_BASE &&
 												static_cast<int>(m.pos.x) == tile_x &&
 												static_cast<int>(m.pos.z) == tile_z; });
 
@@ -1359,11 +1679,21 @@ std::vector<Model> Augmentinel::GetModelStack(int tile_x, int tile_z)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Set aside the current landscape so the next one can be patched into its mesh.
+void Augmentinel::KeepLandscape()
+{
+	if (m_landscape.IsHeightfield())
+		m_spare_landscape = std::move(m_landscape);
+
+	m_landscape = {};
+}
+
 void Augmentinel::ChangeState(GameState new_state)
 {
 	auto old_state = m_state;
 	m_state = new_state;
 	m_substate = 0;
+	++m_scene_version;
 
 	// Stop tunes and looping sounds only when transitioning between
 	// landscape select and game (either direction). This prevents sounds
@@ -1381,15 +1711,31 @@ void Augmentinel::ChangeState(GameState new_state)
 	// Note: We don't stop AudioType::Effect as they are short one-shots
 	// Note: We don't stop AudioType::Music - music continues across states
 
+	// Fast-forwarding only applies to gameplay, where the turbo key can change it
+	if (old_state == GameState::Game && new_state != GameState::Game)
+		m_interrupts.SetTurbo(1);
+
 	// Clear model cache when changing states to prevent stale geometry
-	// from being reused when memory addresses are recycled
+	// from being reused when memory addresses are recycled. The landscape
+	// outlives the change, so its buffers are kept for patching in place.
 	auto renderer = std::dynamic_pointer_cast<OpenGLRenderer>(m_pView);
 	if (renderer)
 	{
-		renderer->ClearModelCache();
+		renderer->ClearModelCache({ &m_landscape, &m_spare_landscape });
 	}
 }
 
+const EmulationStats* Augmentinel::GetEmulationStats() const
+{
+	return m_spectrum ? &m_spectrum->GetStats() : nullptr;
+}
+
+void Augmentinel::ResetEmulationStats()
+{
+	if (m_spectrum)
+		m_spectrum->ResetStats();
+}
+
 bool Augmentinel::RunUntilStateChange()
 {
 	auto current_state = m_state;
@@ -1501,73 +1847,55 @@ void Augmentinel::OnInputAction(uint8_t &action)
 
 void Augmentinel::OnGameModelChanged(int id, bool player_initiated)
 {
-	// Temporary ids used for destroyed or changed models.
-	static int fade_out_id = TEMP_ID_BASE;
-
 	if (m_state != GameState::Game)
 		return;
 
+	// Any model change may move, add or remove ray targets.
+	++m_scene_version;
+
 	auto new_model = m_spectrum->GetModel(id);
 	auto existing_model = FindModelById(id);
 
 	// Model removed?
 	if (existing_model && new_model.type == ModelType::Unknown)
 	{
-		m_pAudio->Play(DISSOLVE_SOUND, AudioType::Effect, existing_model->pos);
+		PlayEffect(DISSOLVE_SOUND, existing_model->pos);
 
 		// Change the id of the destroyed model so the slot can be reused.
-		existing_model->id = fade_out_id++;
-
-		m_animations.push_back({AnimationType::Dissolve,
-														existing_model->id,
-														DISSOLVE_TIME,
-														0.0f,
-														1.0f,
-														!player_initiated});
+		m_model_grid.Remove(id);
+		auto fade_out_id = m_drawn_models.Retire(id);
+
+		AddAnimation({AnimationType::Dissolve, fade_out_id, DISSOLVE_TIME, 0.0f, 1.0f, !player_initiated});
 	}
 	else
 	{
 		// Model added?
 		if (!existing_model)
 		{
-			m_pAudio->Play(DISSOLVE_SOUND, AudioType::Effect, new_model.pos);
+			PlayEffect(DISSOLVE_SOUND, new_model.pos);
 
 			new_model.dissolved = 1.0f;
-			m_drawn_models.push_back(std::move(new_model));
-
-			m_animations.push_back({AnimationType::Dissolve,
-															id,
-															DISSOLVE_TIME,
-															1.0f,
-															0.0f,
-															!player_initiated});
+			m_model_grid.Update(m_drawn_models.Add(std::move(new_model)));
+
+			AddAnimation({AnimationType::Dissolve, id, DISSOLVE_TIME, 1.0f, 0.0f, !player_initiated});
 		}
 		else
 		{
 			if (new_model.type != existing_model->type)
 			{
 				// Change the id of the old model so the slot can be reused.
-				existing_model->id = fade_out_id++;
+				m_model_grid.Remove(id);
+				auto fade_out_id = m_drawn_models.Retire(id);
 
-				m_animations.push_back({AnimationType::Dissolve,
-																existing_model->id,
-																DISSOLVE_TIME,
-																0.0f,
-																1.0f,
-																!player_initiated});
+				AddAnimation({AnimationType::Dissolve, fade_out_id, DISSOLVE_TIME, 0.0f, 1.0f, !player_initiated});
 
-				m_pAudio->Play(DISSOLVE_SOUND, AudioType::Effect, new_model.pos);
+				PlayEffect(DISSOLVE_SOUND, new_model.pos);
 
 				// Append the new model, initially faded out.
 				new_model.dissolved = 1.0f;
-				m_drawn_models.push_back(std::move(new_model));
-
-				m_animations.push_back({AnimationType::Dissolve,
-																id,
-																DISSOLVE_TIME,
-																1.0f,
-																0.0f,
-																!player_initiated});
+				m_model_grid.Update(m_drawn_models.Add(std::move(new_model)));
+
+				AddAnimation({AnimationType::Dissolve, id, DISSOLVE_TIME, 1.0f, 0.0f, !player_initiated});
 			}
 			// Model rotated?
 			else if (new_model.rot.y != existing_model->rot.y)
@@ -1579,11 +1907,10 @@ void Augmentinel::OnGameModelChanged(int id, bool player_initiated)
 				else if ((current_rot_y - new_model.rot.y) >= XM_PI)
 					current_rot_y -= XM_2PI;
 
-				m_animations.push_back({AnimationType::Yaw,
-																id,
-																SENTINEL_TURN_TIME,
-																current_rot_y,
-																new_model.rot.y});
+				// Refit to the final orientation, rather than following the animation.
+				m_model_grid.Update(new_model);
+
+				AddAnimation({AnimationType::Yaw, id, SENTINEL_TURN_TIME, current_rot_y, new_model.rot.y});
 			}
 		}
 	}
@@ -1670,8 +1997,8 @@ bool Augmentinel::OnTargetActionTile(InputAction action, int &tile_x, int &tile_
 			m_spectrum->LandscapeVertexIndexToTile(static_cast<int>(vertex_index), tile_x, tile_z);
 
 			// Get the vertices of the triangle.
-			auto &vertices = *(model->m_pVertices);
-			auto &indices = *(model->m_pIndices);
+			auto &vertices = model->m_pMesh->Vertices();
+			auto &indices = model->m_pMesh->Indices();
 
 			auto &v1 = vertices[indices[vertex_index + 0]].pos;
 			auto &v2 = vertices[indices[vertex_index + 1]].pos;
@@ -1939,10 +2266,10 @@ void Augmentinel::OnSoundEffect(int effect_number, int idx)
 	switch (effect_number)
 	{
 	case 0: // Sentinel/sentry turn
-		m_pAudio->Play(TURN_SOUND, AudioType::Effect, source_pos);
+		PlayEffect(TURN_SOUND, source_pos);
 		break;
 	case 1: // Meanie turn
-		m_pAudio->Play(MEANIE_SOUND, AudioType::Effect, source_pos);
+		PlayEffect(MEANIE_SOUND, source_pos);
 		break;
 	case 2: // Absorb sound (unused on Spectrum)
 		break;
@@ -2,6 +2,13 @@
 #include "Game.h"
 #include "Spectrum.h"
 #include "Animate.h"
+#include "InterruptScheduler.h"
+#include "LandscapeIndex.h"
+#include "ModelGrid.h"
+#include "ModelSlotMap.h"
+#include "RayBatch.h"
+#include "TileVisibility.h"
+#include "JobSystem.h"
 
 enum class GameState
 {
@@ -19,6 +26,12 @@ public:
 	void Frame(float elapsed_seconds) final override;
 	bool WantsToQuit() const final override;
 
+	const EmulationStats* GetEmulationStats() const;
+	void ResetEmulationStats();
+	const InterruptScheduler& GetInterruptScheduler() const { return m_interrupts; }
+	uint32_t GetPointerCacheHits() const { return m_pointer_cache.hits; }
+	uint32_t GetPointerCacheTests() const { return m_pointer_cache.tests; }
+
 #ifdef PLATFORM_WINDOWS
 	static void Options(HINSTANCE hinst, HWND hwndParent);
 #endif
@@ -28,14 +41,18 @@ protected:
 	void PlayMusic();
 
 	bool SceneRayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget& hit, int ignore_id = -1);
+	bool PointerRayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget& hit);
 	bool SceneModelVisible(XMVECTOR vRayPos, const Model& model, int ignore_id = -1);
 	bool SceneTileVisible(XMVECTOR vRayPos, int tile_x, int tile_z);
 
+	void KeepLandscape();
 	void ChangeState(GameState new_state);
 	bool RunUntilStateChange();
 
 	std::vector<Model> GetModelStack(int tile_x, int tile_z);
 	void AddText(const std::string& str, float x_centre, float y, float z, int colour = 1, bool reversed = false);
+	void AddAnimation(const Animation& animation);
+	void PlayEffect(const std::wstring& filename, XMFLOAT3 pos);
 	bool PlayerAnimationActive() const;
 	void SetSeen(SeenState seen_state);
 
@@ -43,6 +60,12 @@ protected:
 	void SaveLastLandscape(int landscape_bcd);
 	void AddLandscapeCode(int landscape_bcd, uint32_t secret_code_bcd);
 	void RemoveLandscapeCode(int landscape_bcd);
+	void AddPreviewText();
+	void UpdateLandscapeFilter();
+	int GetGridIndex() const;
+	void BrowseLandscapeGrid();
+	void UpdateThumbnails();
+	void DrawLandscapeGrid();
 
 	// IModelSource implementation.
 	Model* FindModelById(int id) final override;
@@ -65,19 +88,25 @@ protected:
 	std::shared_ptr<Audio> m_pAudio;
 
 	Model m_landscape;
+	Model m_spare_landscape;
 	Model m_player;
 	Model m_skybox;
 	Model m_pointer_line;
 	Model m_pointer_target;
 
-	std::vector<Model> m_drawn_models;
+	ModelSlotMap m_drawn_models;
+	ModelGrid m_model_grid;
+	TileVisibility m_tile_visibility;
+	uint32_t m_scene_version{ 0 };
 	std::vector<Model> m_text;
 	std::vector<Model> m_icons;
 	std::vector<Animation> m_animations;
+	std::set<std::wstring> m_turbo_sounds;
 
 	int m_seen_count{ 0 };
 	bool m_seen_sound{ false };
 	float m_frame_time{ 0.0f };
+	InterruptScheduler m_interrupts;
 
 	GameState m_state{ GameState::Unknown };
 	int m_substate{ 0 };
@@ -92,5 +121,28 @@ protected:
 
 	int m_landscape_bcd{ 0 };
 	std::map<int, uint32_t> m_codes;
+	std::map<int, uint32_t> m_browse_codes;
+	LandscapeIndex m_landscape_index;
+	int m_filter_sentries{ -1 };
+	bool m_grid_view{ false };
+	int m_grid_landscape_bcd{ 0 };
+	int m_thumbnail_bcd{ -1 };	// landscape whose thumbnail is being generated, or -1.
+	LandscapeGeometry m_thumbnail_geometry;
+	TaskGroup m_thumbnail_task;	// after the geometry it writes, so it's waited for first on destruction.
+	std::set<int> m_thumbnail_failed;
 	std::unique_ptr<Spectrum> m_spectrum;
+
+	// Last aiming pointer ray test, reused while the ray and scene are unchanged.
+	struct PointerRayCache
+	{
+		XMFLOAT3 pos{};
+		XMFLOAT3 dir{};
+		int ignore_id{ -1 };
+		uint32_t scene_version{ 0 };
+		bool valid{ false };
+		bool is_hit{ false };
+		RayTarget hit{};
+		uint32_t hits{ 0 };
+		uint32_t tests{ 0 };
+	} m_pointer_cache;
 };
@@ -0,0 +1,90 @@
+#include "Platform.h"
+#include "FrameArena.h"
+
+static thread_local FrameArena* thread_arena = nullptr;	// arena owned by this thread.
+static std::atomic<FrameArena*> current_arena{ nullptr };	// for counting heap fallbacks.
+
+FrameArena::FrameArena(size_t chunk_size)
+	: m_chunk_size(chunk_size)
+{
+	AddChunk(m_chunk_size);
+	m_heap_fallbacks = 0;
+}
+
+FrameArena::~FrameArena()
+{
+	if (thread_arena == this)
+		thread_arena = nullptr;
+
+	auto pArena = this;
+	current_arena.compare_exchange_strong(pArena, nullptr);
+}
+
+/*static*/ FrameArena* FrameArena::Current()
+{
+	return thread_arena;
+}
+
+/*static*/ void FrameArena::SetCurrent(FrameArena* pArena)
+{
+	thread_arena = pArena;
+	current_arena = pArena;
+}
+
+/*static*/ void FrameArena::CountHeapFallback()
+{
+	if (auto pArena = current_arena.load())
+		++pArena->m_heap_fallbacks;
+}
+
+void FrameArena::AddChunk(size_t size)
+{
+	m_chunks.push_back({ std::make_unique<uint8_t[]>(size), size });
+	m_offset = 0;
+	++m_heap_fallbacks;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	auto& chunk = m_chunks.back();
+	auto base = reinterpret_cast<uintptr_t>(chunk.data.get());
+	auto aligned = (base + m_offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+
+	// Start a new chunk if this one is full, large enough for oversized requests.
+	if (aligned + size > base + chunk.size)
+	{
+		AddChunk(std::max(m_chunk_size, size + alignment));
+		return Allocate(size, alignment);
+	}
+
+	m_offset = static_cast<size_t>(aligned + size - base);
+	m_bytes += size;
+	return reinterpret_cast<void*>(aligned);
+}
+
+// Release everything allocated this frame. If the frame needed extra chunks,
+// replace them all with one chunk big enough for the whole frame, so the next
+// frame like it makes no heap allocations.
+void FrameArena::Reset()
+{
+	m_last_frame.bytes = m_bytes;
+	m_last_frame.heap_fallbacks = m_heap_fallbacks.exchange(0);
+
+	if (m_chunks.size() > 1)
+	{
+		auto capacity = Capacity();
+		m_chunks.clear();
+		AddChunk(capacity);
+	}
+
+	m_offset = 0;
+	m_bytes = 0;
+}
+
+size_t FrameArena::Capacity() const
+{
+	size_t capacity = 0;
+	for (auto& chunk : m_chunks)
+		capacity += chunk.size;
+	return capacity;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+
+// Linear allocator for temporary containers used within a single frame.
+// Allocation just advances an offset, freeing does nothing, and everything is
+// released at once by Reset at the end of the frame. The arena is used only
+// by the thread that made it current, so other threads fall back to the heap.
+class FrameArena
+{
+public:
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+	struct Stats
+	{
+		size_t bytes{ 0 };					// arena memory used.
+		uint32_t heap_fallbacks{ 0 };		// arena chunk growth, plus frame containers that fell back to the heap.
+	};
+
+	explicit FrameArena(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+	~FrameArena();
+
+	// Arena for the calling thread, or null if it doesn't have one.
+	static FrameArena* Current();
+	static void SetCurrent(FrameArena* pArena);
+	static void CountHeapFallback();
+
+	void* Allocate(size_t size, size_t alignment);
+	void Reset();
+
+	size_t Capacity() const;
+	Stats GetLastFrameStats() const { return m_last_frame; }
+
+protected:
+	struct Chunk
+	{
+		std::unique_ptr<uint8_t[]> data;
+		size_t size;
+	};
+
+	void AddChunk(size_t size);
+
+	std::vector<Chunk> m_chunks;
+	size_t m_chunk_size{ 0 };
+	size_t m_offset{ 0 };					// within the last chunk.
+	size_t m_bytes{ 0 };
+	std::atomic<uint32_t> m_heap_fallbacks{ 0 };
+	Stats m_last_frame;
+};
+
+// STL allocator drawing from the calling thread's frame arena, or the heap if
+// it has none. Containers using it must not outlive the frame, and must only
+// grow on the thread that created them.
+template <typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	FrameAllocator() noexcept : m_pArena(FrameArena::Current()) {}
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept : m_pArena(other.m_pArena) {}
+
+	T* allocate(size_t n)
+	{
+		if (m_pArena)
+			return static_cast<T*>(m_pArena->Allocate(n * sizeof(T), alignof(T)));
+
+		FrameArena::CountHeapFallback();
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t) noexcept
+	{
+		if (!m_pArena)
+			::operator delete(p);
+	}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& other) const noexcept { return m_pArena == other.m_pArena; }
+	template <typename U>
+	bool operator!=(const FrameAllocator<U>& other) const noexcept { return m_pArena != other.m_pArena; }
+
+private:
+	template <typename U>
+	friend class FrameAllocator;
+
+	FrameArena* m_pArena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+template <typename T, typename Compare = std::less<T>>
+using FrameSet = std::set<T, Compare, FrameAllocator<T>>;
@@ -7,6 +7,7 @@ class Audio;
 struct IScene
 {
 	virtual void DrawModel(Model& model, const Model& linkedModel = {}) = 0;
+	virtual void DrawModels(std::vector<Model>& models, const Model& linkedModel = {}, int hidden_id = -1) = 0;
 	virtual void DrawControllers() = 0;
 	virtual bool IsPointerVisible() const = 0;
 };
@@ -0,0 +1,70 @@
+#include "Platform.h"
+#include "InstanceTable.h"
+
+void InstanceTable::Clear()
+{
+	m_centre_x.clear();
+	m_centre_y.clear();
+	m_centre_z.clear();
+	m_radius.clear();
+	m_world.clear();
+	m_visible.clear();
+}
+
+// Add a model's world transform and bounding sphere, returning its index.
+size_t InstanceTable::Add(const Model& model, const Model& linkedModel)
+{
+	auto mWorld = model.GetWorldMatrix(linkedModel);
+	auto& bounds = model.m_pMesh->Bounds();
+
+	XMFLOAT3 centre;
+	XMStoreFloat3(&centre, XMVector3TransformCoord(XMLoadFloat3(&bounds.Center), mWorld));
+
+	// Scale the radius by the largest axis scale, in case the transform isn't uniform.
+	auto max_scale = std::max({
+		XMVectorGetX(XMVector3Length(mWorld.r[0])),
+		XMVectorGetX(XMVector3Length(mWorld.r[1])),
+		XMVectorGetX(XMVector3Length(mWorld.r[2])) });
+	auto radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&bounds.Extents))) * max_scale;
+
+	m_centre_x.push_back(centre.x);
+	m_centre_y.push_back(centre.y);
+	m_centre_z.push_back(centre.z);
+	m_radius.push_back(radius);
+	m_world.emplace_back();
+	XMStoreFloat4x4(&m_world.back(), mWorld);
+	m_visible.push_back(1);
+
+	return m_world.size() - 1;
+}
+
+void InstanceTable::Cull(const XMMATRIX& mViewProjection)
+{
+	// Clip planes from the columns of the view-projection, for a left handed
+	// projection with clip space depth from 0 to w.
+	auto mColumns = XMMatrixTranspose(mViewProjection);
+	XMVECTOR planes[] = {
+		mColumns.r[3] + mColumns.r[0],
+		mColumns.r[3] - mColumns.r[0],
+		mColumns.r[3] + mColumns.r[1],
+		mColumns.r[3] - mColumns.r[1],
+		mColumns.r[2],
+		mColumns.r[3] - mColumns.r[2] };
+
+	auto count = m_world.size();
+	std::fill(m_visible.begin(), m_visible.end(), 1);
+
+	// One plane at a time over all instances, so the inner loop only streams
+	// through the centre and radius arrays.
+	for (auto& vPlane : planes)
+	{
+		XMFLOAT4 plane;
+		XMStoreFloat4(&plane, XMPlaneNormalize(vPlane));
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto dist = plane.x * m_centre_x[i] + plane.y * m_centre_y[i] + plane.z * m_centre_z[i] + plane.w;
+			m_visible[i] &= static_cast<uint8_t>(dist >= -m_radius[i]);
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Model.h"
+
+// Per-instance state for a set of models, held as parallel arrays so a pass
+// over every instance reads only the fields it needs. Rebuilt each frame from
+// the models, keeping its storage so steady state doesn't allocate.
+class InstanceTable
+{
+public:
+	void Clear();
+	size_t Add(const Model& model, const Model& linkedModel = {});
+
+	// Mark the instances whose world bounding sphere may be inside the clip
+	// volume of a view-projection. Conservative, like the per-model box test.
+	void Cull(const XMMATRIX& mViewProjection);
+
+	size_t Size() const { return m_world.size(); }
+	bool IsVisible(size_t idx) const { return m_visible[idx] != 0; }
+	XMMATRIX GetWorldMatrix(size_t idx) const { return XMLoadFloat4x4(&m_world[idx]); }
+
+protected:
+	std::vector<float> m_centre_x, m_centre_y, m_centre_z;
+	std::vector<float> m_radius;
+	std::vector<XMFLOAT4X4> m_world;
+	std::vector<uint8_t> m_visible;	// not vector<bool>, so the cull loop stays simple to vectorise.
+};
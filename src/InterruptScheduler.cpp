@@ -0,0 +1,57 @@
+#include "Platform.h"
+#include "InterruptScheduler.h"
+#include <cmath>
+
+void InterruptScheduler::SetPeriod(float period)
+{
+	m_period = std::max(period, 0.001f);
+}
+
+void InterruptScheduler::SetTurbo(int factor)
+{
+	m_turbo = std::min(std::max(factor, 1), MAX_TURBO_FACTOR);
+}
+
+void InterruptScheduler::Reset()
+{
+	m_accumulated = 0.0f;
+	m_pending = 0;
+	m_deferred_count = 0;
+	m_dropped_count = 0;
+}
+
+// Returns the number of interrupts to run this frame.
+int InterruptScheduler::BeginFrame(float elapsed)
+{
+	m_accumulated += elapsed * m_turbo;
+
+	// Convert whole elapsed periods into pending interrupts.
+	auto due = static_cast<int>(m_accumulated / m_period);
+	m_accumulated -= due * m_period;
+	auto backlog = m_pending;
+	m_pending += due;
+
+	// Discard anything beyond the backlog limit, as it can never be caught up.
+	// The limit scales with the turbo factor, which needs more per frame.
+	auto max_backlog = MAX_INTERRUPT_BACKLOG * m_turbo;
+	if (m_pending > max_backlog)
+	{
+		m_dropped_count += m_pending - max_backlog;
+		m_pending = max_backlog;
+	}
+
+	// Fast-forwarding runs everything due in the time this frame actually took,
+	// however long rendering was throttled for, plus the usual share of backlog.
+	auto max_run = MAX_INTERRUPTS_PER_FRAME;
+	if (IsTurbo())
+		max_run += static_cast<int>(std::ceil(elapsed * m_turbo / m_period));
+
+	auto run = std::min(m_pending, max_run);
+	m_pending -= run;
+
+	// Track how many were held over for later frames. The oldest run first, so
+	// only those beyond what's left of the earlier backlog are newly deferred.
+	m_deferred_count += std::max(m_pending - std::max(backlog - run, 0), 0);
+
+	return run;
+}
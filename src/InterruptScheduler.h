@@ -0,0 +1,34 @@
+#pragma once
+
+constexpr auto MAX_INTERRUPTS_PER_FRAME = 4;	// Most Spectrum interrupts run in a single rendered frame.
+constexpr auto MAX_INTERRUPT_BACKLOG = 25;		// Most interrupts carried over before the excess is dropped.
+constexpr auto MAX_TURBO_FACTOR = 50;			// Fastest fast-forward, as a multiple of real time.
+
+// Paces the Spectrum interrupt handler against real elapsed time. Rather than
+// running every overdue interrupt at once after a long frame, the catch-up is
+// spread over following frames so emulation cost per frame stays bounded.
+// A turbo factor runs emulated time faster than real time, for fast-forwarding.
+class InterruptScheduler
+{
+public:
+	void SetPeriod(float period);
+	void SetTurbo(int factor);
+	void Reset();
+
+	int BeginFrame(float elapsed);
+
+	int Turbo() const { return m_turbo; }
+	bool IsTurbo() const { return m_turbo > 1; }
+	int Pending() const { return m_pending; }
+	uint32_t DeferredCount() const { return m_deferred_count; }
+	uint32_t DroppedCount() const { return m_dropped_count; }
+
+protected:
+	float m_period{ 1.0f };
+	int m_turbo{ 1 };
+	float m_accumulated{ 0.0f };
+	int m_pending{ 0 };
+
+	uint32_t m_deferred_count{ 0 };
+	uint32_t m_dropped_count{ 0 };
+};
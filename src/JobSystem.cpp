@@ -0,0 +1,271 @@
+#include "Platform.h"
+#include "JobSystem.h"
+
+static std::atomic<JobSystem*> current_jobs{ nullptr };
+static thread_local JobSystem* thread_owner = nullptr;	// scheduler this thread belongs to.
+static thread_local size_t thread_index = 0;			// its deque in that scheduler.
+
+TaskGroup::TaskGroup(JobSystem* pJobs)
+	: m_pJobs(pJobs ? pJobs : JobSystem::Current())
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+	Wait();
+}
+
+// Queue a job in the group, or run it now if there's no scheduler.
+void TaskGroup::Run(std::function<void()> fn)
+{
+	if (!m_pJobs)
+	{
+		fn();
+		return;
+	}
+
+	++m_pending;
+	m_pJobs->Push({ std::move(fn), this, std::chrono::steady_clock::now() });
+}
+
+void TaskGroup::RunBackground(std::function<void()> fn)
+{
+	if (!m_pJobs || m_pJobs->Size() == 1)
+	{
+		fn();
+		return;
+	}
+
+	++m_pending;
+	m_pJobs->PushBackground({ std::move(fn), this, std::chrono::steady_clock::now() });
+}
+
+void TaskGroup::Wait()
+{
+	while (m_pending > 0)
+	{
+		if (!m_pJobs->RunOne())
+			std::this_thread::yield();
+	}
+}
+
+JobSystem::JobSystem(unsigned int num_threads)
+{
+	num_threads = std::max(1u, num_threads);
+	for (unsigned int i = 0; i < num_threads; ++i)
+		m_queues.push_back(std::make_unique<Queue>());
+
+	thread_owner = this;
+	thread_index = 0;
+
+	for (unsigned int i = 1; i < num_threads; ++i)
+		m_threads.emplace_back(&JobSystem::WorkerThread, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_quit = true;
+	}
+	m_sleep_cv.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+
+	if (thread_owner == this)
+		thread_owner = nullptr;
+
+	auto pJobs = this;
+	current_jobs.compare_exchange_strong(pJobs, nullptr);
+}
+
+/*static*/ JobSystem* JobSystem::Current()
+{
+	return current_jobs;
+}
+
+/*static*/ void JobSystem::SetCurrent(JobSystem* pJobs)
+{
+	current_jobs = pJobs;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t min_range, const RangeFunction& fn)
+{
+	min_range = std::max<size_t>(min_range, 1);
+	if (count <= min_range || Size() == 1)
+	{
+		if (count)
+			fn(0, count);
+		return;
+	}
+
+	// A few ranges per thread leaves room to balance uneven ranges by stealing.
+	auto num_ranges = std::min(count / min_range, Size() * 4);
+	auto range_size = (count + num_ranges - 1) / num_ranges;
+
+	TaskGroup group(this);
+	for (size_t begin = 0; begin < count; begin += range_size)
+	{
+		auto end = std::min(begin + range_size, count);
+		group.Run([&fn, begin, end] { fn(begin, end); });
+	}
+	group.Wait();
+}
+
+JobSystem::Stats JobSystem::GetStats() const
+{
+	Stats stats;
+	stats.jobs = m_stat_jobs;
+	stats.steals = m_stat_steals;
+	stats.total_latency_us = m_stat_latency_us;
+	stats.max_latency_us = m_stat_max_latency_us;
+	return stats;
+}
+
+void JobSystem::ResetStats()
+{
+	m_stat_jobs = 0;
+	m_stat_steals = 0;
+	m_stat_latency_us = 0;
+	m_stat_max_latency_us = 0;
+}
+
+void JobSystem::Push(Job&& job)
+{
+	auto& queue = (thread_owner == this) ? *m_queues[thread_index] : m_shared_queue;
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	// Taking the lock first means a worker can't miss the wake-up between checking and sleeping.
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		++m_queued;
+	}
+	m_sleep_cv.notify_one();
+}
+
+void JobSystem::PushBackground(Job&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_background_queue.mutex);
+		m_background_queue.jobs.push_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		++m_queued;
+	}
+	m_sleep_cv.notify_one();
+}
+
+// Run the newest job of our own, or one from outside, or steal one. Worker
+// threads with nothing else to do take the oldest background job.
+bool JobSystem::RunOne()
+{
+	Job job;
+	auto own_idx = (thread_owner == this) ? thread_index : m_queues.size();
+	if ((own_idx < m_queues.size() && Pop(own_idx, job)) || Steal(own_idx, job))
+	{
+		Execute(job);
+		return true;
+	}
+
+	if (thread_owner == this && thread_index != 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_background_queue.mutex);
+			if (m_background_queue.jobs.empty())
+				return false;
+
+			job = std::move(m_background_queue.jobs.front());
+			m_background_queue.jobs.pop_front();
+		}
+
+		Execute(job);
+		return true;
+	}
+
+	return false;
+}
+
+bool JobSystem::Pop(size_t thread_idx, Job& job)
+{
+	auto& queue = *m_queues[thread_idx];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+		return false;
+
+	job = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	return true;
+}
+
+// Take the oldest job from outside the scheduler, or from another thread.
+bool JobSystem::Steal(size_t thread_idx, Job& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_shared_queue.mutex);
+		if (!m_shared_queue.jobs.empty())
+		{
+			job = std::move(m_shared_queue.jobs.front());
+			m_shared_queue.jobs.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i <= m_queues.size(); ++i)
+	{
+		auto victim_idx = (thread_idx + i) % m_queues.size();
+		if (victim_idx == thread_idx)
+			continue;
+
+		auto& queue = *m_queues[victim_idx];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			++m_stat_steals;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+	--m_queued;
+
+	auto latency_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - job.queued).count());
+	++m_stat_jobs;
+	m_stat_latency_us += latency_us;
+
+	auto max_latency_us = m_stat_max_latency_us.load();
+	while (latency_us > max_latency_us && !m_stat_max_latency_us.compare_exchange_weak(max_latency_us, latency_us))
+		;
+
+	job.fn();
+
+	if (job.pGroup)
+		--job.pGroup->m_pending;
+}
+
+void JobSystem::WorkerThread(size_t thread_idx)
+{
+	thread_owner = this;
+	thread_index = thread_idx;
+
+	while (!m_quit)
+	{
+		if (!RunOne())
+		{
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_sleep_cv.wait(lock, [&] { return m_quit || m_queued > 0; });
+		}
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class JobSystem;
+
+// Jobs whose completion can be waited for together. Waiting runs queued
+// jobs rather than blocking, so groups can be used from inside other jobs.
+class TaskGroup
+{
+public:
+	explicit TaskGroup(JobSystem* pJobs = nullptr);
+	~TaskGroup();
+
+	void Run(std::function<void()> fn);
+	void Wait();
+
+	// Queue a long job that only worker threads take, so a wait on any group
+	// never ends up running it. Runs now if there are no worker threads.
+	void RunBackground(std::function<void()> fn);
+	bool IsDone() const { return m_pending == 0; }
+
+protected:
+	friend class JobSystem;
+
+	JobSystem* m_pJobs{ nullptr };
+	std::atomic<int> m_pending{ 0 };
+};
+
+// Work-stealing job scheduler. Each thread pushes and pops jobs at the back of
+// its own deque, and idle threads steal the oldest job from the front of
+// another's. The thread that creates the scheduler is thread 0, and takes
+// part whenever it waits on a task group.
+class JobSystem
+{
+public:
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	struct Stats
+	{
+		uint64_t jobs{ 0 };
+		uint64_t steals{ 0 };
+		uint64_t total_latency_us{ 0 };	// queued to started, summed over all jobs.
+		uint64_t max_latency_us{ 0 };
+	};
+
+	explicit JobSystem(unsigned int num_threads = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	// Scheduler owned by the application, or null if there isn't one.
+	static JobSystem* Current();
+	static void SetCurrent(JobSystem* pJobs);
+
+	// Call fn on consecutive ranges covering [0,count), of at least min_range items each.
+	void ParallelFor(size_t count, size_t min_range, const RangeFunction& fn);
+
+	size_t Size() const { return m_queues.size(); }
+	Stats GetStats() const;
+	void ResetStats();
+
+protected:
+	friend class TaskGroup;
+
+	struct Job
+	{
+		std::function<void()> fn;
+		TaskGroup* pGroup;
+		std::chrono::steady_clock::time_point queued;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void Push(Job&& job);
+	void PushBackground(Job&& job);
+	bool RunOne();
+	bool Pop(size_t thread_idx, Job& job);
+	bool Steal(size_t thread_idx, Job& job);
+	void Execute(Job& job);
+	void WorkerThread(size_t thread_idx);
+
+	std::vector<std::unique_ptr<Queue>> m_queues;	// one per thread, including thread 0.
+	Queue m_shared_queue;							// jobs from threads outside the scheduler.
+	Queue m_background_queue;						// long jobs, for worker threads only.
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_sleep_cv;
+	std::atomic<int> m_queued{ 0 };
+	std::atomic<bool> m_quit{ false };
+
+	std::atomic<uint64_t> m_stat_jobs{ 0 };
+	std::atomic<uint64_t> m_stat_steals{ 0 };
+	std::atomic<uint64_t> m_stat_latency_us{ 0 };
+	std::atomic<uint64_t> m_stat_max_latency_us{ 0 };
+};
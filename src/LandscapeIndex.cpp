@@ -0,0 +1,313 @@
+#include "Platform.h"
+#include "LandscapeIndex.h"
+#include "Settings.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+constexpr auto LANDSCAPE_INDEX_FILE = L"landscapes.csv";
+constexpr auto LANDSCAPE_INDEX_HEADER = "landscape,code,sentries,height,trees,distance";
+constexpr auto MAX_GENERATE_FRAMES = 2000;	// max emulated frames to reach a generated landscape.
+
+// Minimal event handler to drive the Spectrum as far as landscape generation.
+struct LandscapeGenerator : public ISentinelEvents
+{
+	int landscape_bcd{ 0 };
+	bool title_screen{ false };
+	bool generated{ false };
+
+	void OnTitleScreen() override { title_screen = true; }
+	void OnLandscapeInput(int& landscape_bcd_, uint32_t& secret_code_bcd) override { landscape_bcd_ = landscape_bcd; secret_code_bcd = 0; }
+	void OnLandscapeGenerated() override { generated = true; }
+	void OnNewPlayerView() override {}
+	void OnPlayerDead() override {}
+	void OnInputAction(uint8_t&) override {}
+	void OnGameModelChanged(int, bool) override {}
+	bool OnTargetActionTile(InputAction, int&, int&) override { return false; }
+	void OnHideEnergyPanel() override {}
+	void OnAddEnergySymbol(int, int) override {}
+	void OnPlayTune(int) override {}
+	void OnSoundEffect(int, int) override {}
+};
+
+struct Condition
+{
+	int LandscapeInfo::* int_field{ nullptr };
+	float LandscapeInfo::* float_field{ nullptr };
+	uint32_t LandscapeInfo::* code_field{ nullptr };
+	std::string op;
+	float value{ 0.0f };
+	uint32_t code{ 0 };
+};
+
+static std::vector<Condition> ParseQuery(const std::string& query)
+{
+	static const std::vector<std::string> ops{ "==", "!=", "<=", ">=", "=", "<", ">" };
+	std::vector<Condition> conditions;
+
+	std::string clause;
+	std::stringstream ss(query);
+	while (ss >> clause)
+	{
+		// Allow comma separated clauses too.
+		clause.erase(std::remove(clause.begin(), clause.end(), ','), clause.end());
+		if (clause.empty())
+			continue;
+
+		Condition condition{};
+		size_t op_pos = std::string::npos;
+		for (auto& op : ops)
+		{
+			op_pos = clause.find(op);
+			if (op_pos != std::string::npos)
+			{
+				condition.op = op;
+				break;
+			}
+		}
+
+		if (op_pos == std::string::npos || op_pos == 0)
+			throw std::runtime_error("Invalid landscape query clause: " + clause);
+
+		auto name = clause.substr(0, op_pos);
+		auto value = clause.substr(op_pos + condition.op.size());
+		if (value.empty())
+			throw std::runtime_error("Missing value in landscape query clause: " + clause);
+
+		if (name == "landscape")
+			condition.int_field = &LandscapeInfo::landscape_bcd, condition.value = static_cast<float>(std::stoul(value, nullptr, 16));
+		else if (name == "code")
+			condition.code_field = &LandscapeInfo::secret_code_bcd, condition.code = std::stoul(value, nullptr, 16);
+		else if (name == "sentries")
+			condition.int_field = &LandscapeInfo::sentries, condition.value = std::stof(value);
+		else if (name == "height")
+			condition.int_field = &LandscapeInfo::max_height, condition.value = std::stof(value);
+		else if (name == "trees")
+			condition.int_field = &LandscapeInfo::trees, condition.value = std::stof(value);
+		else if (name == "distance")
+			condition.float_field = &LandscapeInfo::sentinel_distance, condition.value = std::stof(value);
+		else
+			throw std::runtime_error("Unknown landscape property: " + name);
+
+		conditions.push_back(condition);
+	}
+
+	return conditions;
+}
+
+static bool Compare(float lhs, const std::string& op, float rhs)
+{
+	if (op == "=" || op == "==") return lhs == rhs;
+	if (op == "!=") return lhs != rhs;
+	if (op == "<") return lhs < rhs;
+	if (op == "<=") return lhs <= rhs;
+	if (op == ">") return lhs > rhs;
+	return lhs >= rhs;
+}
+
+static bool Matches(const LandscapeInfo& info, const std::vector<Condition>& conditions)
+{
+	for (auto& condition : conditions)
+	{
+		bool match;
+		if (condition.code_field)
+			match = (condition.op == "!=") == (info.*condition.code_field != condition.code);
+		else if (condition.int_field)
+			match = Compare(static_cast<float>(info.*condition.int_field), condition.op, condition.value);
+		else
+			match = Compare(info.*condition.float_field, condition.op, condition.value);
+
+		if (!match)
+			return false;
+	}
+
+	return true;
+}
+
+static bool IsBCD(int value)
+{
+	for (; value; value >>= 4)
+	{
+		if ((value & 0xf) > 9)
+			return false;
+	}
+
+	return true;
+}
+
+std::wstring LandscapeIndex::DefaultPath()
+{
+	// Keep the index alongside the settings file.
+	return fs::path(settings_path).replace_filename(LANDSCAPE_INDEX_FILE).wstring();
+}
+
+// Run a fresh Spectrum until the requested landscape has been generated.
+static void RunToLandscape(Spectrum& spectrum, const LandscapeGenerator& generator)
+{
+	auto frame_count = MAX_GENERATE_FRAMES;
+	while (!generator.generated && frame_count-- > 0)
+		spectrum.RunFrame();
+
+	if (!generator.generated)
+		throw std::runtime_error("Failed to generate landscape " + std::to_string(generator.landscape_bcd));
+}
+
+LandscapeInfo LandscapeIndex::Generate(int landscape_bcd)
+{
+	LandscapeGenerator generator;
+	generator.landscape_bcd = landscape_bcd;
+
+	Spectrum spectrum(L"sentinel.sna", &generator);
+	RunToLandscape(spectrum, generator);
+
+	return spectrum.GetLandscapeInfo();
+}
+
+LandscapeGeometry LandscapeIndex::GenerateGeometry(int landscape_bcd)
+{
+	LandscapeGenerator generator;
+	generator.landscape_bcd = landscape_bcd;
+
+	Spectrum spectrum(L"sentinel.sna", &generator);
+	RunToLandscape(spectrum, generator);
+
+	LandscapeGeometry geometry;
+	geometry.info = spectrum.GetLandscapeInfo();
+	geometry.landscape = spectrum.ExtractLandscape();
+	geometry.models = spectrum.ExtractPlacedModels();
+	geometry.palette = spectrum.GetGamePalette();
+	return geometry;
+}
+
+bool LandscapeIndex::Load(const std::wstring& filename)
+{
+	std::ifstream file{ fs::path(filename) };
+	if (!file)
+		return false;
+
+	m_landscapes.clear();
+
+	std::string line;
+	std::getline(file, line);
+	if (line != LANDSCAPE_INDEX_HEADER)
+		return false;
+
+	while (std::getline(file, line))
+	{
+		std::replace(line.begin(), line.end(), ',', ' ');
+		std::stringstream ss(line);
+
+		LandscapeInfo info{};
+		ss >> std::hex >> info.landscape_bcd >> info.secret_code_bcd >> std::dec;
+		ss >> info.sentries >> info.max_height >> info.trees >> info.sentinel_distance;
+
+		if (ss.fail())
+			return false;
+
+		Add(info);
+	}
+
+	return true;
+}
+
+bool LandscapeIndex::Save(const std::wstring& filename) const
+{
+	std::ofstream file{ fs::path(filename) };
+	if (!file)
+		return false;
+
+	file << LANDSCAPE_INDEX_HEADER << "\n";
+	for (auto& [landscape_bcd, info] : m_landscapes)
+	{
+		file << std::hex << std::uppercase << std::setfill('0')
+			<< std::setw(4) << info.landscape_bcd << ","
+			<< std::setw(8) << info.secret_code_bcd << ","
+			<< std::dec << info.sentries << ","
+			<< info.max_height << ","
+			<< info.trees << ","
+			<< std::fixed << std::setprecision(2) << info.sentinel_distance << "\n";
+	}
+
+	return file.good();
+}
+
+void LandscapeIndex::Build(bool hex_landscapes, ProgressFunction progress)
+{
+	// Landscape numbers are BCD unless hex landscapes are enabled, which wrap after DFFF.
+	std::vector<int> landscapes;
+	for (int landscape = 0; landscape < 0xe000; ++landscape)
+	{
+		if (hex_landscapes || IsBCD(landscape))
+			landscapes.push_back(landscape);
+	}
+
+	std::vector<LandscapeInfo> results(landscapes.size());
+	std::atomic<size_t> next{ 0 };
+	std::atomic<int> done{ 0 };
+	std::mutex progress_mutex;
+	std::exception_ptr error;
+
+	// Each worker has its own emulated Spectrum, so landscapes generate in parallel.
+	auto worker = [&]
+	{
+		for (size_t i; (i = next++) < landscapes.size(); )
+		{
+			try
+			{
+				results[i] = Generate(landscapes[i]);
+			}
+			catch (...)
+			{
+				// Stop all workers, and report the failure once they've finished.
+				std::lock_guard<std::mutex> lock(progress_mutex);
+				error = std::current_exception();
+				next = landscapes.size();
+				break;
+			}
+
+			auto count = ++done;
+			if (progress)
+			{
+				std::lock_guard<std::mutex> lock(progress_mutex);
+				progress(count, static_cast<int>(landscapes.size()));
+			}
+		}
+	};
+
+	std::vector<std::thread> threads(std::max(1u, std::thread::hardware_concurrency()));
+	for (auto& thread : threads)
+		thread = std::thread(worker);
+	for (auto& thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	for (auto& info : results)
+		Add(info);
+}
+
+void LandscapeIndex::Add(const LandscapeInfo& info)
+{
+	m_landscapes[info.landscape_bcd] = info;
+}
+
+const LandscapeInfo* LandscapeIndex::Find(int landscape_bcd) const
+{
+	auto it = m_landscapes.find(landscape_bcd);
+	return (it != m_landscapes.end()) ? &it->second : nullptr;
+}
+
+std::vector<const LandscapeInfo*> LandscapeIndex::Query(const std::string& query) const
+{
+	auto conditions = ParseQuery(query);
+
+	std::vector<const LandscapeInfo*> matches;
+	for (auto& [landscape_bcd, info] : m_landscapes)
+	{
+		if (Matches(info, conditions))
+			matches.push_back(&info);
+	}
+
+	return matches;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Spectrum.h"
+
+// Geometry of a generated landscape, for rendering away from the main game.
+struct LandscapeGeometry
+{
+	LandscapeInfo info{};
+	Model landscape;
+	std::vector<Model> models;
+	std::vector<XMFLOAT4> palette;
+};
+
+// Properties of generated landscapes, so they can be searched without
+// running the Spectrum to regenerate each one.
+class LandscapeIndex
+{
+public:
+	static std::wstring DefaultPath();
+	static LandscapeInfo Generate(int landscape_bcd);
+	static LandscapeGeometry GenerateGeometry(int landscape_bcd);
+
+	bool Load(const std::wstring& filename);
+	bool Save(const std::wstring& filename) const;
+
+	using ProgressFunction = std::function<void(int done, int total)>;
+	void Build(bool hex_landscapes, ProgressFunction progress = nullptr);
+
+	void Add(const LandscapeInfo& info);
+	const LandscapeInfo* Find(int landscape_bcd) const;
+	std::vector<const LandscapeInfo*> Query(const std::string& query) const;
+
+	size_t Size() const { return m_landscapes.size(); }
+	bool Empty() const { return m_landscapes.empty(); }
+
+protected:
+	std::map<int, LandscapeInfo> m_landscapes;
+};
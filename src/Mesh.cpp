@@ -0,0 +1,335 @@
+#include "Platform.h"
+#include "Mesh.h"
+#include <unordered_map>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices, std::vector<uint8_t>&& heightmap)
+	: m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_heightmap(std::move(heightmap))
+{
+	assert(m_vertices.size() && m_indices.size());
+	assert((m_indices.size() % 3) == 0);
+
+	// Calculate normals if they're missing.
+	const auto& normal = m_vertices[0].normal;
+	if (normal.x == 0.0f && normal.y == 0.0f && normal.z == 0.0f)
+	{
+		for (size_t i = 0; i < m_indices.size(); i += 3)
+		{
+			auto v1 = XMLoadFloat3(&m_vertices[m_indices[i + 0]].pos);
+			auto v2 = XMLoadFloat3(&m_vertices[m_indices[i + 1]].pos);
+			auto v3 = XMLoadFloat3(&m_vertices[m_indices[i + 2]].pos);
+			auto n = XMVector3Normalize(XMVector3Cross(
+				XMVectorSubtract(v2, v1), XMVectorSubtract(v3, v2)));
+
+			XMStoreFloat3(&m_vertices[m_indices[i + 0]].normal, n);
+			XMStoreFloat3(&m_vertices[m_indices[i + 1]].normal, n);
+			XMStoreFloat3(&m_vertices[m_indices[i + 2]].normal, n);
+		}
+	}
+
+	// Determine the bounding box to eliminate unnecessary triangle ray testing.
+	UpdateBounds();
+
+	// Heightfields are ray tested from their heightmap, so never use the triangle layout.
+	if (m_heightmap.empty())
+		m_pTriangles = std::make_unique<TriangleSoA>(m_vertices, m_indices);
+}
+
+Mesh::Mesh(const Mesh& other)
+	: m_vertices(other.m_vertices), m_indices(other.m_indices), m_boundingBox(other.m_boundingBox),
+	m_version(other.m_version), m_short_indices(other.m_short_indices), m_heightmap(other.m_heightmap)
+{
+	if (other.m_pTriangles)
+		m_pTriangles = std::make_unique<TriangleSoA>(*other.m_pTriangles);
+}
+
+std::vector<Vertex>& Mesh::EditVertices()
+{
+	// The triangle layout would be stale after the edit, and all of it needs uploading.
+	m_pTriangles.reset();
+	m_dirty_begin = 0;
+	m_dirty_end = m_vertices.size();
+	++m_version;
+	return m_vertices;
+}
+
+// Hash and compare vertices by value, so identical ones can be welded.
+static_assert(sizeof(Vertex) == 9 * sizeof(uint32_t), "Vertex must not contain padding");
+
+struct VertexHash
+{
+	size_t operator()(const Vertex& v) const
+	{
+		// FNV-1a over the vertex bytes.
+		auto bytes = reinterpret_cast<const uint8_t*>(&v);
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < sizeof(v); ++i)
+			hash = (hash ^ bytes[i]) * 16777619u;
+		return hash;
+	}
+};
+
+struct VertexEqual
+{
+	bool operator()(const Vertex& a, const Vertex& b) const
+	{
+		return std::memcmp(&a, &b, sizeof(a)) == 0;
+	}
+};
+
+// Triangle order for the post-transform vertex cache, after Tom Forsyth's
+// "Linear-Speed Vertex Cache Optimisation". Each step emits the highest scoring
+// triangle, favouring vertices still in the cache and those with few triangles left.
+static std::vector<uint32_t> VertexCacheOrder(const std::vector<uint32_t>& indices, size_t vertex_count)
+{
+	constexpr int CACHE_SIZE = 32;
+	const auto triangle_count = indices.size() / 3;
+
+	// Triangles using each vertex, with the unemitted ones first in each list.
+	std::vector<uint32_t> remaining(vertex_count);
+	for (auto i : indices)
+		++remaining[i];
+
+	std::vector<uint32_t> first_triangle(vertex_count + 1);
+	for (size_t v = 0; v < vertex_count; ++v)
+		first_triangle[v + 1] = first_triangle[v] + remaining[v];
+
+	std::vector<uint32_t> vertex_triangles(indices.size());
+	auto fill = first_triangle;
+	for (size_t i = 0; i < indices.size(); ++i)
+		vertex_triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+	std::vector<int> cache_pos(vertex_count, -1);
+	std::vector<float> vertex_score(vertex_count);
+	std::vector<float> triangle_score(triangle_count);
+	std::vector<bool> emitted(triangle_count);
+
+	auto score = [&](uint32_t v)
+	{
+		if (!remaining[v])
+			return -1.0f;
+
+		float s = 0.0f;
+		auto pos = cache_pos[v];
+		if (pos >= 0)
+			s = (pos < 3) ? 0.75f : std::pow(1.0f - (pos - 3) / static_cast<float>(CACHE_SIZE - 3), 1.5f);
+
+		return s + 2.0f / std::sqrt(static_cast<float>(remaining[v]));
+	};
+
+	auto rescore_triangle = [&](uint32_t t)
+	{
+		triangle_score[t] = vertex_score[indices[t * 3 + 0]] +
+			vertex_score[indices[t * 3 + 1]] +
+			vertex_score[indices[t * 3 + 2]];
+	};
+
+	for (uint32_t v = 0; v < vertex_count; ++v)
+		vertex_score[v] = score(v);
+	for (uint32_t t = 0; t < triangle_count; ++t)
+		rescore_triangle(t);
+
+	std::vector<uint32_t> order;
+	order.reserve(indices.size());
+	std::vector<uint32_t> cache, new_cache;
+	int best = -1;
+
+	for (size_t n = 0; n < triangle_count; ++n)
+	{
+		// Nothing in the cache to continue from, so take the best of the rest.
+		if (best < 0)
+		{
+			for (uint32_t t = 0; t < triangle_count; ++t)
+			{
+				if (!emitted[t] && (best < 0 || triangle_score[t] > triangle_score[best]))
+					best = static_cast<int>(t);
+			}
+		}
+
+		emitted[best] = true;
+		new_cache.clear();
+
+		for (int i = 0; i < 3; ++i)
+		{
+			auto v = indices[best * 3 + i];
+			order.push_back(v);
+
+			// Move the triangle past the end of the vertex's remaining list.
+			auto begin = vertex_triangles.begin() + first_triangle[v];
+			auto end = begin + remaining[v];
+			auto it = std::find(begin, end, static_cast<uint32_t>(best));
+			if (it != end)
+			{
+				std::iter_swap(it, end - 1);
+				--remaining[v];
+			}
+
+			if (std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end())
+				new_cache.push_back(v);
+		}
+
+		for (auto v : cache)
+		{
+			if (std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end())
+				new_cache.push_back(v);
+		}
+
+		// Rescore everything that moved in or out of the cache.
+		for (size_t i = 0; i < new_cache.size(); ++i)
+		{
+			auto v = new_cache[i];
+			cache_pos[v] = (i < CACHE_SIZE) ? static_cast<int>(i) : -1;
+			vertex_score[v] = score(v);
+		}
+
+		best = -1;
+		for (auto v : new_cache)
+		{
+			for (auto i = first_triangle[v]; i < first_triangle[v] + remaining[v]; ++i)
+			{
+				auto t = vertex_triangles[i];
+				rescore_triangle(t);
+
+				if (best < 0 || triangle_score[t] > triangle_score[best])
+					best = static_cast<int>(t);
+			}
+		}
+
+		if (new_cache.size() > CACHE_SIZE)
+			new_cache.resize(CACHE_SIZE);
+		std::swap(cache, new_cache);
+	}
+
+	return order;
+}
+
+void Mesh::Optimise()
+{
+	assert(m_heightmap.empty());
+
+	// Weld identical vertices, keeping the first of each.
+	std::unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> welded;
+	std::vector<uint32_t> remap(m_vertices.size());
+	std::vector<Vertex> unique_vertices;
+
+	for (size_t i = 0; i < m_vertices.size(); ++i)
+	{
+		auto next = static_cast<uint32_t>(unique_vertices.size());
+		auto [it, inserted] = welded.emplace(m_vertices[i], next);
+		if (inserted)
+			unique_vertices.push_back(m_vertices[i]);
+
+		remap[i] = it->second;
+	}
+
+	for (auto& index : m_indices)
+		index = remap[index];
+
+	m_indices = VertexCacheOrder(m_indices, unique_vertices.size());
+
+	// Store the vertices in the order they're first used, for pre-transform locality.
+	constexpr auto unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> first_use(unique_vertices.size(), unused);
+	m_vertices.clear();
+
+	for (auto& index : m_indices)
+	{
+		if (first_use[index] == unused)
+		{
+			first_use[index] = static_cast<uint32_t>(m_vertices.size());
+			m_vertices.push_back(unique_vertices[index]);
+		}
+
+		index = first_use[index];
+	}
+
+	m_short_indices = m_vertices.size() <= std::numeric_limits<uint16_t>::max() + 1u;
+	m_pTriangles = std::make_unique<TriangleSoA>(m_vertices, m_indices);
+	++m_version;
+}
+
+MeshStats Mesh::Stats() const
+{
+	MeshStats stats;
+	stats.vertices = m_vertices.size();
+	stats.triangles = m_indices.size() / 3;
+	stats.bytes = m_vertices.size() * sizeof(Vertex) +
+		m_indices.size() * (m_short_indices ? sizeof(uint16_t) : sizeof(uint32_t));
+	return stats;
+}
+
+void Mesh::UpdateVertices(size_t first, const Vertex* vertices, size_t count)
+{
+	assert(first + count <= m_vertices.size());
+
+	std::copy(vertices, vertices + count, m_vertices.begin() + first);
+	m_dirty_begin = std::min(m_dirty_begin, first);
+	m_dirty_end = std::max(m_dirty_end, first + count);
+
+	m_pTriangles.reset();
+	++m_version;
+}
+
+void Mesh::UpdateBounds()
+{
+	BoundingBox::CreateFromPoints(
+		m_boundingBox,
+		m_vertices.size(),
+		&m_vertices[0].pos,
+		sizeof(m_vertices[0]));
+}
+
+// Vertices changed by UpdateVertices since the renderer last uploaded them.
+bool Mesh::GetDirtyRange(size_t& first, size_t& count) const
+{
+	if (m_dirty_begin >= m_dirty_end)
+		return false;
+
+	first = m_dirty_begin;
+	count = m_dirty_end - m_dirty_begin;
+	return true;
+}
+
+void Mesh::ClearDirtyRange()
+{
+	m_dirty_begin = SIZE_MAX;
+	m_dirty_end = 0;
+}
+
+void Mesh::SetHeightmap(std::vector<uint8_t>&& heightmap)
+{
+	m_heightmap = std::move(heightmap);
+	ClearHeightmapDirtyRange();
+	if (!m_heightmap.empty())
+		m_pTriangles.reset();
+	++m_version;
+}
+
+void Mesh::UpdateHeightmap(size_t index, uint8_t entry)
+{
+	assert(index < m_heightmap.size());
+
+	m_heightmap[index] = entry;
+	m_heightmap_dirty_begin = std::min(m_heightmap_dirty_begin, index);
+	m_heightmap_dirty_end = std::max(m_heightmap_dirty_end, index + 1);
+	++m_version;
+}
+
+// Heightmap entries changed by UpdateHeightmap since the renderer last uploaded them.
+bool Mesh::GetHeightmapDirtyRange(size_t& first, size_t& count) const
+{
+	if (m_heightmap_dirty_begin >= m_heightmap_dirty_end)
+		return false;
+
+	first = m_heightmap_dirty_begin;
+	count = m_heightmap_dirty_end - m_heightmap_dirty_begin;
+	return true;
+}
+
+void Mesh::ClearHeightmapDirtyRange()
+{
+	m_heightmap_dirty_begin = SIZE_MAX;
+	m_heightmap_dirty_end = 0;
+}
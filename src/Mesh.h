@@ -0,0 +1,76 @@
+#pragma once
+#include "Vertex.h"
+#include "TriangleSoA.h"
+
+// Sizes reported by the mesh optimisation pass.
+struct MeshStats
+{
+	size_t vertices{};
+	size_t triangles{};
+	size_t bytes{};
+
+	MeshStats& operator+=(const MeshStats& other)
+	{
+		vertices += other.vertices;
+		triangles += other.triangles;
+		bytes += other.bytes;
+		return *this;
+	}
+};
+
+// Geometry shared by every model drawn with it: vertices, indices, the
+// model space bounding box and the triangle layout for ray tests. Models
+// refer to it through a MeshRef, so copying a model doesn't copy its geometry.
+class Mesh
+{
+public:
+	Mesh(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices, std::vector<uint8_t>&& heightmap = {});
+	Mesh(const Mesh& other);
+
+	const std::vector<Vertex>& Vertices() const { return m_vertices; }
+	const std::vector<uint32_t>& Indices() const { return m_indices; }
+	const BoundingBox& Bounds() const { return m_boundingBox; }
+	const TriangleSoA* Triangles() const { return m_pTriangles.get(); }
+
+	std::vector<Vertex>& EditVertices();
+
+	// Weld identical vertices and reorder the triangles for the post-transform
+	// vertex cache. Not for meshes whose vertex layout is relied on (landscape).
+	void Optimise();
+	MeshStats Stats() const;
+
+	// Set by Optimise when the renderer can use 16-bit indices.
+	bool ShortIndices() const { return m_short_indices; }
+
+	// Overwrite a run of vertices in place, marking them for the renderer to
+	// upload again. Call UpdateBounds once a batch of updates is done.
+	void UpdateVertices(size_t first, const Vertex* vertices, size_t count);
+	void UpdateBounds();
+
+	// Incremented by every edit, so cached data derived from the mesh can tell it's stale.
+	uint32_t Version() const { return m_version; }
+	bool GetDirtyRange(size_t& first, size_t& count) const;
+	void ClearDirtyRange();
+
+	// Landscape map entries (height << 4 | tile shape) in rows of map points,
+	// for renderers that generate the landscape vertices on the GPU.
+	const std::vector<uint8_t>& Heightmap() const { return m_heightmap; }
+	void SetHeightmap(std::vector<uint8_t>&& heightmap);
+	void UpdateHeightmap(size_t index, uint8_t entry);
+	bool GetHeightmapDirtyRange(size_t& first, size_t& count) const;
+	void ClearHeightmapDirtyRange();
+
+protected:
+	std::vector<Vertex> m_vertices;
+	std::vector<uint32_t> m_indices;
+	BoundingBox m_boundingBox;
+	std::unique_ptr<const TriangleSoA> m_pTriangles;
+	uint32_t m_version{ 0 };
+	bool m_short_indices{ false };
+	size_t m_dirty_begin{ SIZE_MAX };
+	size_t m_dirty_end{ 0 };
+
+	std::vector<uint8_t> m_heightmap;
+	size_t m_heightmap_dirty_begin{ SIZE_MAX };
+	size_t m_heightmap_dirty_end{ 0 };
+};
@@ -0,0 +1,66 @@
+#include "Platform.h"
+#include "MeshRegistry.h"
+#include <mutex>
+#include <unordered_map>
+#include <cstring>
+
+std::array<Mesh*, MeshRegistry::MAX_MESHES> MeshRegistry::s_meshes{};
+
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<Mesh>> registry_meshes;
+static std::unordered_multimap<size_t, MeshHandle> registry_by_hash;
+
+// FNV-1a over the vertex and index data.
+static size_t ContentHash(const Mesh& mesh)
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto add_bytes = [&](const void* data, size_t size)
+	{
+		auto bytes = reinterpret_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+	};
+
+	add_bytes(mesh.Vertices().data(), mesh.Vertices().size() * sizeof(Vertex));
+	add_bytes(mesh.Indices().data(), mesh.Indices().size() * sizeof(uint32_t));
+	return static_cast<size_t>(hash);
+}
+
+static bool SameContent(const Mesh& a, const Mesh& b)
+{
+	return a.Vertices().size() == b.Vertices().size() &&
+		a.Indices().size() == b.Indices().size() &&
+		!std::memcmp(a.Vertices().data(), b.Vertices().data(), a.Vertices().size() * sizeof(Vertex)) &&
+		!std::memcmp(a.Indices().data(), b.Indices().data(), a.Indices().size() * sizeof(uint32_t));
+}
+
+MeshHandle MeshRegistry::Intern(std::unique_ptr<Mesh>&& pMesh)
+{
+	assert(pMesh && pMesh->Heightmap().empty());
+	auto hash = ContentHash(*pMesh);
+
+	std::lock_guard<std::mutex> lock(registry_mutex);
+
+	auto [begin, end] = registry_by_hash.equal_range(hash);
+	for (auto it = begin; it != end; ++it)
+	{
+		if (SameContent(*Get(it->second), *pMesh))
+			return it->second;
+	}
+
+	// Full, so the caller keeps the mesh to itself.
+	if (registry_meshes.size() == MAX_MESHES)
+		return 0;
+
+	auto handle = static_cast<MeshHandle>(registry_meshes.size() + 1);
+	s_meshes[handle - 1] = pMesh.get();
+	registry_meshes.push_back(std::move(pMesh));
+	registry_by_hash.emplace(hash, handle);
+	return handle;
+}
+
+size_t MeshRegistry::Count()
+{
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	return registry_meshes.size();
+}
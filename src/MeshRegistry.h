@@ -0,0 +1,62 @@
+#pragma once
+#include "Mesh.h"
+
+// Handle to an interned mesh, with 0 for none.
+using MeshHandle = uint32_t;
+
+// Immutable meshes kept for the life of the program and deduplicated by
+// content, such as the snapshot models, glyphs and icons. Models refer to
+// them by handle, so copying a model doesn't touch a reference count.
+class MeshRegistry
+{
+public:
+	static constexpr size_t MAX_MESHES = 4096;
+
+	// Returns the handle of an identical mesh if there is one. Thread safe.
+	static MeshHandle Intern(std::unique_ptr<Mesh>&& pMesh);
+	static size_t Count();
+
+	static Mesh* Get(MeshHandle handle)
+	{
+		assert(handle && handle <= MAX_MESHES);
+		return s_meshes[handle - 1];
+	}
+
+private:
+	static std::array<Mesh*, MAX_MESHES> s_meshes;
+};
+
+// A model's mesh: either an interned mesh handle, or a mesh of its own that
+// may be shared with copies of the model until one of them edits it.
+class MeshRef
+{
+public:
+	MeshRef() = default;
+	MeshRef(std::nullptr_t) {}
+	MeshRef(std::shared_ptr<Mesh> pMesh) : m_pOwned(std::move(pMesh)) {}
+	explicit MeshRef(MeshHandle handle) : m_handle(handle) {}
+
+	// Intern a mesh, keeping it as the model's own if the registry is full.
+	static MeshRef Interned(std::unique_ptr<Mesh>&& pMesh)
+	{
+		if (auto handle = MeshRegistry::Intern(std::move(pMesh)))
+			return MeshRef(handle);
+
+		return MeshRef(std::shared_ptr<Mesh>(std::move(pMesh)));
+	}
+
+	Mesh* get() const { return m_handle ? MeshRegistry::Get(m_handle) : m_pOwned.get(); }
+	Mesh* operator->() const { return get(); }
+	Mesh& operator*() const { return *get(); }
+	explicit operator bool() const { return m_handle || m_pOwned; }
+
+	MeshHandle Handle() const { return m_handle; }
+	void reset() { m_handle = 0; m_pOwned.reset(); }
+
+	// Edits must copy the mesh first if it's interned or shared with other models.
+	bool IsShared() const { return m_handle || m_pOwned.use_count() > 1; }
+
+private:
+	MeshHandle m_handle{ 0 };
+	std::shared_ptr<Mesh> m_pOwned;
+};
@@ -1,5 +1,8 @@
 #include "Platform.h"
 #include "Model.h"
+#include <atomic>
+
+static std::atomic<uint32_t> matrix_recomputes{ 0 };
 
 /*static*/ Model Model::CreateBlock(float width, float height, float depth, uint32_t colour_idx, ModelType type)
 {
@@ -44,55 +47,28 @@
 			std::swap(indices[i + 1], indices[i + 2]);
 	}
 
-	auto pVertices = std::make_shared<std::vector<Vertex>>(std::move(vertices));
-	auto pIndices = std::make_shared<std::vector<uint32_t>>(std::move(indices));
-
-	auto model = Model{ pVertices, pIndices, type };
+	auto model = Model{ std::move(vertices), std::move(indices), type };
 	model.lighting = false;
 	return model;
 }
 
 Model::Model(
-	std::shared_ptr<std::vector<Vertex>>& pVertices,
-	std::shared_ptr<std::vector<uint32_t>>& pIndices,
+	std::vector<Vertex>&& vertices,
+	std::vector<uint32_t>&& indices,
 	ModelType type_,
 	int id_)
+	: Model(std::make_shared<Mesh>(std::move(vertices), std::move(indices)), type_, id_)
 {
-	assert(pVertices->size() && pIndices->size());
-	assert((pIndices->size() % 3) == 0);
+}
 
+Model::Model(
+	const MeshRef& mesh,
+	ModelType type_,
+	int id_)
+{
 	id = id_;
 	type = type_;
-	m_pVertices = pVertices;
-	m_pIndices = pIndices;
-
-	auto& indices = *m_pIndices;
-	auto& vertices = *m_pVertices;
-
-	// Calculate normals if they're missing.
-	const auto& normal = vertices[0].normal;
-	if (normal.x == 0.0f && normal.y == 0.0f && normal.z == 0.0f)
-	{
-		for (size_t i = 0; i < m_pIndices->size(); i += 3)
-		{
-			auto v1 = XMLoadFloat3(&vertices[indices[i + 0]].pos);
-			auto v2 = XMLoadFloat3(&vertices[indices[i + 1]].pos);
-			auto v3 = XMLoadFloat3(&vertices[indices[i + 2]].pos);
-			auto n = XMVector3Normalize(XMVector3Cross(
-				XMVectorSubtract(v2, v1), XMVectorSubtract(v3, v2)));
-
-			XMStoreFloat3(&vertices[indices[i + 0]].normal, n);
-			XMStoreFloat3(&vertices[indices[i + 1]].normal, n);
-			XMStoreFloat3(&vertices[indices[i + 2]].normal, n);
-		}
-	}
-
-	// Determine the bounding box to eliminate unnecessary triangle ray testing.
-	BoundingBox::CreateFromPoints(
-		m_boundingBox,
-		vertices.size(),
-		&vertices[0].pos,
-		sizeof(vertices[0]));
+	m_pMesh = mesh;
 }
 
 Model::operator bool() const
@@ -100,13 +76,38 @@ Model::operator bool() const
 	return type != ModelType::Unknown;
 }
 
-XMMATRIX Model::GetWorldMatrix(const Model& rel) const
+// Rebuild the cached matrices if pos, rot or scale have changed since they were built.
+// Models shared between threads must be brought up to date first, so threads only read.
+void Model::UpdateMatrices() const
 {
+	if (m_matrices_valid &&
+		pos.x == m_matrix_pos.x && pos.y == m_matrix_pos.y && pos.z == m_matrix_pos.z &&
+		rot.x == m_matrix_rot.x && rot.y == m_matrix_rot.y && rot.z == m_matrix_rot.z &&
+		scale == m_matrix_scale)
+	{
+		return;
+	}
+
 	auto mRotation = XMMatrixRotationRollPitchYaw(rot.x, rot.y, rot.z);
 	auto mScale = XMMatrixScaling(scale, scale, scale);
 	auto mTranslation = XMMatrixTranslation(pos.x, pos.y, pos.z);
 	auto mWorld = mRotation * mScale * mTranslation;
 
+	XMStoreFloat4x4(&m_world, mWorld);
+	XMStoreFloat4x4(&m_inv_world, XMMatrixInverse(nullptr, mWorld));
+	m_matrix_pos = pos;
+	m_matrix_rot = rot;
+	m_matrix_scale = scale;
+	m_matrices_valid = true;
+
+	++matrix_recomputes;
+}
+
+XMMATRIX Model::GetWorldMatrix(const Model& rel) const
+{
+	UpdateMatrices();
+	auto mWorld = XMLoadFloat4x4(&m_world);
+
 	// Is the model moving relative to another model?
 	if (rel)
 	{
@@ -121,14 +122,30 @@ XMMATRIX Model::GetWorldMatrix(const Model& rel) const
 	return mWorld;
 }
 
-std::vector<XMVECTOR> Model::GetBoundingBox() const
+XMMATRIX Model::GetInverseWorldMatrix() const
+{
+	UpdateMatrices();
+	return XMLoadFloat4x4(&m_inv_world);
+}
+
+/*static*/ uint32_t Model::GetMatrixRecomputeCount()
+{
+	return matrix_recomputes;
+}
+
+/*static*/ void Model::ResetMatrixRecomputeCount()
+{
+	matrix_recomputes = 0;
+}
+
+FrameVector<XMVECTOR> Model::GetBoundingBox() const
 {
 	static constexpr auto CUBOID_VERTICES = 8;
 
 	std::array <XMFLOAT3, CUBOID_VERTICES> model_corners;
-	m_boundingBox.GetCorners(model_corners.data());
+	m_pMesh->Bounds().GetCorners(model_corners.data());
 
-	std::vector<XMVECTOR> world_corners;
+	FrameVector<XMVECTOR> world_corners;
 	world_corners.reserve(CUBOID_VERTICES);
 
 	auto mWorld = GetWorldMatrix();
@@ -144,12 +161,26 @@ std::vector<XMVECTOR> Model::GetBoundingBox() const
 bool Model::BoxTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, float& dist) const
 {
 	// Convert ray to model coordinates using the inverted model matrix.
-	auto mInvWorld = XMMatrixInverse(nullptr, GetWorldMatrix());
+	auto mInvWorld = GetInverseWorldMatrix();
 	vRayOrigin = XMVector4Transform(vRayOrigin, mInvWorld);
 	vRayDir = XMVector4Transform(vRayDir, mInvWorld);
 
 	// Test the ray against the model's bounding box.
-	return m_boundingBox.Intersects(vRayOrigin, vRayDir, dist);
+	return m_pMesh->Bounds().Intersects(vRayOrigin, vRayDir, dist);
+}
+
+// Ray test a single triangle, given the index of its first vertex index.
+static bool TriangleRayTest(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t idx, XMVECTOR vRayOrigin, XMVECTOR vRayDir, float& dist)
+{
+	auto& pos0 = vertices[indices[idx + 0]].pos;
+	auto& pos1 = vertices[indices[idx + 1]].pos;
+	auto& pos2 = vertices[indices[idx + 2]].pos;
+
+	auto V0 = XMVectorSet(pos0.x, pos0.y, pos0.z, 1.0f);
+	auto V1 = XMVectorSet(pos1.x, pos1.y, pos1.z, 1.0f);
+	auto V2 = XMVectorSet(pos2.x, pos2.y, pos2.z, 1.0f);
+
+	return TriangleTests::Intersects(vRayOrigin, vRayDir, V0, V1, V2, dist);
 }
 
 bool Model::RayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, RayTarget& hit) const
@@ -159,38 +190,48 @@ bool Model::RayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, RayTarget& hit) const
 	auto closest_idx = std::numeric_limits<size_t>::max();
 
 	// Convert ray to model coordinates using the inverted model matrix.
-	auto mInvWorld = XMMatrixInverse(nullptr, GetWorldMatrix());
+	auto mInvWorld = GetInverseWorldMatrix();
 	vRayOrigin = XMVector4Transform(vRayOrigin, mInvWorld);
 	vRayDir = XMVector4Normalize(XMVector4Transform(vRayDir, mInvWorld));
 
 	// Early rejection if ray doesn't touch bounding box.
-	if (!m_boundingBox.Intersects(vRayOrigin, vRayDir, dist))
+	if (!m_pMesh->Bounds().Intersects(vRayOrigin, vRayDir, dist))
 		return false;
 
-	auto& indices = *m_pIndices;
-	auto& vertices = *m_pVertices;
+	auto& indices = m_pMesh->Indices();
+	auto& vertices = m_pMesh->Vertices();
 
-	for (size_t idx = 0; idx < m_pIndices->size(); idx += 3)
-	{
-		auto& pos0 = vertices[indices[idx + 0]].pos;
-		auto& pos1 = vertices[indices[idx + 1]].pos;
-		auto& pos2 = vertices[indices[idx + 2]].pos;
+	// Landscapes only need the tiles under the ray path testing.
+	if (IsHeightfield())
+		return HeightfieldRayTest(vRayOrigin, vRayDir, std::max(dist, 0.0f), hit);
 
-		auto V0 = XMVectorSet(pos0.x, pos0.y, pos0.z, 1.0f);
-		auto V1 = XMVectorSet(pos1.x, pos1.y, pos1.z, 1.0f);
-		auto V2 = XMVectorSet(pos2.x, pos2.y, pos2.z, 1.0f);
+	if (auto pTriangles = m_pMesh->Triangles())
+	{
+		XMFLOAT3 origin, dir;
+		XMStoreFloat3(&origin, vRayOrigin);
+		XMStoreFloat3(&dir, vRayDir);
 
-		if (TriangleTests::Intersects(vRayOrigin, vRayDir, V0, V1, V2, dist))
+		size_t tri = 0;
+		if (pTriangles->RayTest(origin, dir, closest_dist, tri))
+			closest_idx = tri * 3;
+	}
+	else
+	{
+		// Edited vertices have no triangle layout, so test them one at a time.
+		for (size_t idx = 0; idx < indices.size(); idx += 3)
 		{
-			if (dist < closest_dist)
+			if (TriangleRayTest(vertices, indices, idx, vRayOrigin, vRayDir, dist))
 			{
-				closest_dist = dist;
-				closest_idx = idx;
+				if (dist < closest_dist)
+				{
+					closest_dist = dist;
+					closest_idx = idx;
+				}
 			}
 		}
 	}
 
-	if (closest_idx < m_pIndices->size())
+	if (closest_idx < indices.size())
 	{
 		hit.model = this;
 		hit.distance = closest_dist;
@@ -201,12 +242,91 @@ bool Model::RayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, RayTarget& hit) const
 	return false;
 }
 
-std::vector<XMFLOAT3> Model::GetTileVertices(int x, int z) const
+bool Model::IsHeightfield() const
+{
+	return type == ModelType::Landscape &&
+		m_pMesh->Indices().size() == (SENTINEL_MAP_SIZE - 1) * (SENTINEL_MAP_SIZE - 1) * ZX_VERTICES_PER_TILE;
+}
+
+// Walk the landscape tiles crossed by a model space ray, in order of distance
+// along it, so the first tile with a hit holds the nearest hit. Each tile's
+// triangles lie within its own footprint, and the index order matches
+// Spectrum::ExtractLandscape, so hit.index is the same as a full mesh test.
+bool Model::HeightfieldRayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, float entry_dist, RayTarget& hit) const
+{
+	static constexpr auto TILES = SENTINEL_MAP_SIZE - 1;
+	static constexpr auto TILE_OFFSET = (SENTINEL_MAP_SIZE / 2) + 0.5f;	// model x/z of tile 0 left edge is -TILE_OFFSET.
+
+	auto& indices = m_pMesh->Indices();
+	auto& vertices = m_pMesh->Vertices();
+
+	XMFLOAT3 origin, dir;
+	XMStoreFloat3(&origin, vRayOrigin);
+	XMStoreFloat3(&dir, vRayDir);
+
+	// Start in the tile where the ray enters the landscape bounds, in tile units.
+	auto start_x = origin.x + dir.x * entry_dist + TILE_OFFSET;
+	auto start_z = origin.z + dir.z * entry_dist + TILE_OFFSET;
+	auto tile_x = std::min(std::max(static_cast<int>(std::floor(start_x)), 0), TILES - 1);
+	auto tile_z = std::min(std::max(static_cast<int>(std::floor(start_z)), 0), TILES - 1);
+
+	// Step direction, distance to the first tile boundary, and distance between boundaries.
+	auto step_x = (dir.x > 0.0f) ? 1 : -1;
+	auto step_z = (dir.z > 0.0f) ? 1 : -1;
+	auto inf = std::numeric_limits<float>::infinity();
+	auto delta_x = (dir.x != 0.0f) ? std::abs(1.0f / dir.x) : inf;
+	auto delta_z = (dir.z != 0.0f) ? std::abs(1.0f / dir.z) : inf;
+	auto next_x = (dir.x != 0.0f) ? entry_dist + ((tile_x + (step_x > 0 ? 1 : 0)) - start_x) / dir.x : inf;
+	auto next_z = (dir.z != 0.0f) ? entry_dist + ((tile_z + (step_z > 0 ? 1 : 0)) - start_z) / dir.z : inf;
+
+	while (tile_x >= 0 && tile_x < TILES && tile_z >= 0 && tile_z < TILES)
+	{
+		auto dist = 0.0f;
+		auto closest_dist = std::numeric_limits<float>::max();
+		auto closest_idx = std::numeric_limits<size_t>::max();
+
+		auto index_base = static_cast<size_t>((tile_z * TILES) + tile_x) * ZX_VERTICES_PER_TILE;
+		for (auto idx = index_base; idx < index_base + ZX_VERTICES_PER_TILE; idx += 3)
+		{
+			if (TriangleRayTest(vertices, indices, idx, vRayOrigin, vRayDir, dist) && dist < closest_dist)
+			{
+				closest_dist = dist;
+				closest_idx = idx;
+			}
+		}
+
+		if (closest_idx < indices.size())
+		{
+			hit.model = this;
+			hit.distance = closest_dist;
+			hit.index = closest_idx;
+			return true;
+		}
+
+		// Step into the next tile along the ray, unless it's vertical.
+		if (next_x == inf && next_z == inf)
+			break;
+		else if (next_x < next_z)
+		{
+			tile_x += step_x;
+			next_x += delta_x;
+		}
+		else
+		{
+			tile_z += step_z;
+			next_z += delta_z;
+		}
+	}
+
+	return false;
+}
+
+FrameVector<XMFLOAT3> Model::GetTileVertices(int x, int z) const
 {
-	std::vector<XMFLOAT3> tile_vertices(ZX_VERTICES_PER_TILE);
+	FrameVector<XMFLOAT3> tile_vertices(ZX_VERTICES_PER_TILE);
 
-	auto& indices = *m_pIndices;
-	auto& vertices = *m_pVertices;
+	auto& indices = m_pMesh->Indices();
+	auto& vertices = m_pMesh->Vertices();
 
 	// This function expects a landscape with 6 indices per tile.
 	assert(type == ModelType::Landscape);
@@ -219,10 +339,10 @@ std::vector<XMFLOAT3> Model::GetTileVertices(int x, int z) const
 	return tile_vertices;
 }
 
-std::vector<XMVECTOR> Model::GetTileCorners(int x, int z) const
+FrameVector<XMVECTOR> Model::GetTileCorners(int x, int z) const
 {
-	std::set<std::pair<float, float>> seen;
-	std::vector<XMVECTOR> world_corners;
+	FrameSet<std::pair<float, float>> seen;
+	FrameVector<XMVECTOR> world_corners;
 	world_corners.reserve(4);
 
 	auto mWorld = GetWorldMatrix();
@@ -242,9 +362,18 @@ std::vector<XMVECTOR> Model::GetTileCorners(int x, int z) const
 }
 
 std::vector<Vertex>& Model::EditVertices()
+{
+	return EditMesh().EditVertices();
+}
+
+Mesh& Model::EditMesh()
 {
 #ifdef PLATFORM_WINDOWS
 	m_pHeapVertices.reset();
 #endif
-	return *m_pVertices;
+	// Copy interned geometry, or geometry shared with other models, before changing it.
+	if (m_pMesh.IsShared())
+		m_pMesh = std::make_shared<Mesh>(*m_pMesh);
+
+	return *m_pMesh;
 }
@@ -1,5 +1,6 @@
 #pragma once
-#include "Vertex.h"
+#include "MeshRegistry.h"
+#include "FrameArena.h"
 #ifdef PLATFORM_WINDOWS
 #include "BufferHeap.h"
 #endif
@@ -26,21 +27,31 @@ public:
 
 	Model() : id(-1), type(ModelType::Unknown), pos{}, rot{}, scale(1.0f), dissolved(0.0f), lighting(true), orthographic(false) {}
 	Model(
-		std::shared_ptr<std::vector<Vertex>>& pVertices,
-		std::shared_ptr<std::vector<uint32_t>>& pIndices,
+		std::vector<Vertex>&& vertices,
+		std::vector<uint32_t>&& indices,
+		ModelType type = ModelType::Unknown,
+		int id = -1);
+	Model(
+		const MeshRef& mesh,
 		ModelType type = ModelType::Unknown,
 		int id = -1);
-	virtual ~Model() = default;
 
 	operator bool() const;
 
 	XMMATRIX GetWorldMatrix(const Model& linkedModel = {}) const;
-	std::vector<XMVECTOR> GetBoundingBox() const;
-	std::vector<XMFLOAT3> GetTileVertices(int x, int z) const;
-	std::vector<XMVECTOR> GetTileCorners(int x, int z) const;
+	XMMATRIX GetInverseWorldMatrix() const;
+	void UpdateMatrices() const;
+	FrameVector<XMVECTOR> GetBoundingBox() const;
+	FrameVector<XMFLOAT3> GetTileVertices(int x, int z) const;
+	FrameVector<XMVECTOR> GetTileCorners(int x, int z) const;
 	bool RayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, RayTarget& hit) const;
 	bool BoxTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, float& dist) const;
 	std::vector<Vertex>& EditVertices();
+	Mesh& EditMesh();
+	bool IsHeightfield() const;
+
+	static uint32_t GetMatrixRecomputeCount();
+	static void ResetMatrixRecomputeCount();
 
 	int id{ -1 };
 	ModelType type{ ModelType::Unknown };
@@ -51,17 +62,26 @@ public:
 	bool lighting{ true };
 	bool orthographic{ false };
 
-	std::shared_ptr<std::vector<Vertex>> m_pVertices;
-	std::shared_ptr<std::vector<uint32_t>> m_pIndices;
+	MeshRef m_pMesh;
 #ifdef PLATFORM_WINDOWS
 	std::shared_ptr<D3D11HeapAllocation> m_pHeapVertices;
 	std::shared_ptr<D3D11HeapAllocation> m_pHeapIndices;
 #endif
-	BoundingBox m_boundingBox;
 
 #ifdef PLATFORM_WINDOWS
 	ComPtr<ID3D11VertexShader> m_pVertexShader;
 	ComPtr<ID3D11PixelShader> m_pPixelShader;
 #endif
+
+protected:
+	// World and inverse world matrices, and the transform they were built from.
+	mutable XMFLOAT4X4 m_world{};
+	mutable XMFLOAT4X4 m_inv_world{};
+	mutable XMFLOAT3 m_matrix_pos{};
+	mutable XMFLOAT3 m_matrix_rot{};
+	mutable float m_matrix_scale{ 0.0f };
+	mutable bool m_matrices_valid{ false };
+
+	bool HeightfieldRayTest(XMVECTOR vRayOrigin, XMVECTOR vRayDir, float entry_dist, RayTarget& hit) const;
 };
 
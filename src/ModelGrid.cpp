@@ -0,0 +1,154 @@
+#include "Platform.h"
+#include "ModelGrid.h"
+
+// Tile (x,z) covers world x-0.5 to x+0.5 (and the same for z).
+static int WorldToTile(float coord)
+{
+	constexpr auto max_tile = SENTINEL_MAP_SIZE - 2;
+	return std::min(std::max(static_cast<int>(std::floor(coord + 0.5f)), 0), max_tile);
+}
+
+void ModelGrid::Clear()
+{
+	m_ranges.clear();
+	for (auto& cell : m_cells)
+		cell.clear();
+}
+
+void ModelGrid::Build(const std::vector<Model>& models)
+{
+	Clear();
+
+	for (auto& model : models)
+		Update(model);
+}
+
+// Add a model, or refit it after a change.
+void ModelGrid::Update(const Model& model)
+{
+	Remove(model.id);
+
+	auto corners = model.GetBoundingBox();
+	XMFLOAT3 min_pos{ FLT_MAX, FLT_MAX, FLT_MAX }, max_pos{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (auto& vCorner : corners)
+	{
+		XMFLOAT3 corner;
+		XMStoreFloat3(&corner, vCorner);
+		min_pos.x = std::min(min_pos.x, corner.x);
+		min_pos.z = std::min(min_pos.z, corner.z);
+		max_pos.x = std::max(max_pos.x, corner.x);
+		max_pos.z = std::max(max_pos.z, corner.z);
+	}
+
+	TileRange range{ WorldToTile(min_pos.x), WorldToTile(min_pos.z), WorldToTile(max_pos.x), WorldToTile(max_pos.z) };
+	for (auto z = range.min_z; z <= range.max_z; ++z)
+	{
+		for (auto x = range.min_x; x <= range.max_x; ++x)
+			m_cells[z * GRID_SIZE + x].push_back(model.id);
+	}
+
+	m_ranges[model.id] = range;
+}
+
+void ModelGrid::Remove(int id)
+{
+	auto it = m_ranges.find(id);
+	if (it == m_ranges.end())
+		return;
+
+	auto& range = it->second;
+	for (auto z = range.min_z; z <= range.max_z; ++z)
+	{
+		for (auto x = range.min_x; x <= range.max_x; ++x)
+		{
+			auto& cell = m_cells[z * GRID_SIZE + x];
+			cell.erase(std::remove(cell.begin(), cell.end(), id), cell.end());
+		}
+	}
+
+	m_ranges.erase(it);
+}
+
+// Find the nearest model hit, stepping through the tiles crossed by the ray. Once
+// a hit is closer than the far edge of the current tile, no later tile can beat it.
+bool ModelGrid::RayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, IModelSource* model_source, RayTarget& hit, int ignore_id, float max_distance) const
+{
+	constexpr auto grid_min = -0.5f;
+	constexpr auto grid_max = GRID_SIZE - 0.5f;
+
+	XMFLOAT3 origin, dir;
+	XMStoreFloat3(&origin, vRayPos);
+	XMStoreFloat3(&dir, XMVector3Normalize(vRayDir));
+
+	// Clip the ray to the grid area, to find where it enters.
+	auto entry_dist = 0.0f, exit_dist = FLT_MAX;
+	for (auto [o, d] : { std::make_pair(origin.x, dir.x), std::make_pair(origin.z, dir.z) })
+	{
+		if (d == 0.0f)
+		{
+			if (o < grid_min || o > grid_max)
+				return false;
+			continue;
+		}
+
+		auto t1 = (grid_min - o) / d;
+		auto t2 = (grid_max - o) / d;
+		entry_dist = std::max(entry_dist, std::min(t1, t2));
+		exit_dist = std::min(exit_dist, std::max(t1, t2));
+	}
+
+	if (entry_dist > exit_dist || entry_dist > max_distance)
+		return false;
+
+	auto start_x = origin.x + dir.x * entry_dist;
+	auto start_z = origin.z + dir.z * entry_dist;
+	auto tile_x = WorldToTile(start_x);
+	auto tile_z = WorldToTile(start_z);
+
+	auto step_x = (dir.x > 0.0f) ? 1 : -1;
+	auto step_z = (dir.z > 0.0f) ? 1 : -1;
+	auto inf = std::numeric_limits<float>::infinity();
+	auto delta_x = (dir.x != 0.0f) ? std::abs(1.0f / dir.x) : inf;
+	auto delta_z = (dir.z != 0.0f) ? std::abs(1.0f / dir.z) : inf;
+	auto next_x = (dir.x != 0.0f) ? entry_dist + ((tile_x + 0.5f * step_x) - start_x) / dir.x : inf;
+	auto next_z = (dir.z != 0.0f) ? entry_dist + ((tile_z + 0.5f * step_z) - start_z) / dir.z : inf;
+
+	RayTarget model_hit;
+	auto closest_dist = FLT_MAX;
+	FrameVector<int> tested;
+
+	while (tile_x >= 0 && tile_x < GRID_SIZE && tile_z >= 0 && tile_z < GRID_SIZE)
+	{
+		for (auto id : m_cells[tile_z * GRID_SIZE + tile_x])
+		{
+			// Models spanning several tiles only need testing once.
+			if (id == ignore_id || std::find(tested.begin(), tested.end(), id) != tested.end())
+				continue;
+			tested.push_back(id);
+
+			auto model = model_source->FindModelById(id);
+			if (model && model->RayTest(vRayPos, vRayDir, model_hit) && model_hit.distance < closest_dist)
+			{
+				closest_dist = model_hit.distance;
+				hit = model_hit;
+			}
+		}
+
+		auto tile_exit = std::min(next_x, next_z);
+		if (closest_dist <= tile_exit || tile_exit > max_distance || tile_exit == inf)
+			break;
+
+		if (next_x < next_z)
+		{
+			tile_x += step_x;
+			next_x += delta_x;
+		}
+		else
+		{
+			tile_z += step_z;
+			next_z += delta_z;
+		}
+	}
+
+	return closest_dist != FLT_MAX;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Animate.h"
+
+// Placed model ids bucketed by the landscape tiles their bounds overlap, so
+// scene ray tests only visit models near the ray path, in distance order.
+class ModelGrid
+{
+public:
+	void Clear();
+	void Build(const std::vector<Model>& models);
+	void Update(const Model& model);
+	void Remove(int id);
+
+	bool RayTest(XMVECTOR vRayPos, XMVECTOR vRayDir, IModelSource* model_source, RayTarget& hit, int ignore_id = -1, float max_distance = FLT_MAX) const;
+
+	size_t Size() const { return m_ranges.size(); }
+
+protected:
+	static constexpr int GRID_SIZE = SENTINEL_MAP_SIZE - 1;
+
+	struct TileRange
+	{
+		int min_x, min_z, max_x, max_z;
+	};
+
+	std::map<int, TileRange> m_ranges;
+	std::array<std::vector<int>, GRID_SIZE * GRID_SIZE> m_cells;
+};
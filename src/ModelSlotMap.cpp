@@ -0,0 +1,112 @@
+#include "Platform.h"
+#include "ModelSlotMap.h"
+
+ModelSlotMap::ModelSlotMap()
+{
+	m_slots.fill(NO_SLOT);
+}
+
+ModelSlotMap::ModelSlotMap(std::vector<Model>&& models)
+	: ModelSlotMap()
+{
+	for (auto& model : models)
+		Add(std::move(model));
+}
+
+void ModelSlotMap::Clear()
+{
+	m_models.clear();
+	m_slots.fill(NO_SLOT);
+	m_temp_slots.clear();
+}
+
+// Index entry for an id, or nullptr for models without one.
+int* ModelSlotMap::SlotEntry(int id)
+{
+	if (id < 0)
+		return nullptr;
+	else if (id < TEMP_ID_BASE)
+		return &m_slots[id];
+
+	auto temp_idx = static_cast<size_t>(id - TEMP_ID_BASE);
+	if (temp_idx >= m_temp_slots.size())
+		m_temp_slots.resize(temp_idx + 1, NO_SLOT);
+
+	return &m_temp_slots[temp_idx];
+}
+
+// Add a model, replacing any existing model with the same id.
+Model& ModelSlotMap::Add(Model&& model)
+{
+	auto entry = SlotEntry(model.id);
+	if (entry && *entry != NO_SLOT)
+	{
+		auto& existing = m_models[*entry];
+		existing = std::move(model);
+		return existing;
+	}
+
+	if (entry)
+		*entry = static_cast<int>(m_models.size());
+
+	m_models.push_back(std::move(model));
+	return m_models.back();
+}
+
+Model* ModelSlotMap::Find(int id)
+{
+	if (id < 0)
+		return nullptr;
+	else if (id < TEMP_ID_BASE)
+		return (m_slots[id] != NO_SLOT) ? &m_models[m_slots[id]] : nullptr;
+
+	auto temp_idx = static_cast<size_t>(id - TEMP_ID_BASE);
+	if (temp_idx >= m_temp_slots.size() || m_temp_slots[temp_idx] == NO_SLOT)
+		return nullptr;
+
+	return &m_models[m_temp_slots[temp_idx]];
+}
+
+bool ModelSlotMap::Remove(int id)
+{
+	if (!Find(id))
+		return false;
+
+	RemoveAt(*SlotEntry(id));
+	return true;
+}
+
+// Move a model to the lowest free temporary id, so its game id can be reused.
+int ModelSlotMap::Retire(int id)
+{
+	auto model = Find(id);
+	if (!model)
+		return -1;
+
+	auto it = std::find(m_temp_slots.begin(), m_temp_slots.end(), NO_SLOT);
+	auto temp_id = TEMP_ID_BASE + static_cast<int>(it - m_temp_slots.begin());
+
+	auto slot = *SlotEntry(id);
+	*SlotEntry(id) = NO_SLOT;
+	*SlotEntry(temp_id) = slot;
+	model->id = temp_id;
+
+	return temp_id;
+}
+
+// Swap the last model into the removed slot, keeping storage dense.
+void ModelSlotMap::RemoveAt(size_t slot)
+{
+	if (auto entry = SlotEntry(m_models[slot].id))
+		*entry = NO_SLOT;
+
+	auto last = m_models.size() - 1;
+	if (slot != last)
+	{
+		m_models[slot] = std::move(m_models[last]);
+		if (auto entry = SlotEntry(m_models[slot].id))
+			*entry = static_cast<int>(slot);
+	}
+
+	m_models.pop_back();
+}
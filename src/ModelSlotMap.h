@@ -0,0 +1,58 @@
+#pragma once
+#include "Model.h"
+
+// Drawn models stored densely for iteration, with a direct id-to-slot index
+// for constant time lookup. Game object ids index a fixed table, temporary
+// ids (for models fading out after their slot is reused) a small free list.
+class ModelSlotMap
+{
+public:
+	static constexpr int TEMP_ID_BASE = 0x100;
+
+	ModelSlotMap();
+	ModelSlotMap(std::vector<Model>&& models);
+
+	void Clear();
+	Model& Add(Model&& model);
+	Model* Find(int id);
+	bool Remove(int id);
+	int Retire(int id);
+
+	// Remove models matching a predicate, returning how many were removed.
+	template <typename Pred>
+	size_t RemoveIf(Pred pred)
+	{
+		size_t removed = 0;
+		for (size_t i = m_models.size(); i-- > 0;)
+		{
+			if (pred(m_models[i]))
+			{
+				RemoveAt(i);
+				++removed;
+			}
+		}
+		return removed;
+	}
+
+	// Models may be modified in place, but not their ids.
+	std::vector<Model>& Models() { return m_models; }
+	const std::vector<Model>& Models() const { return m_models; }
+
+	auto begin() { return m_models.begin(); }
+	auto end() { return m_models.end(); }
+	auto begin() const { return m_models.begin(); }
+	auto end() const { return m_models.end(); }
+	size_t size() const { return m_models.size(); }
+	bool empty() const { return m_models.empty(); }
+	Model& operator[](size_t i) { return m_models[i]; }
+
+protected:
+	static constexpr int NO_SLOT = -1;
+
+	int* SlotEntry(int id);
+	void RemoveAt(size_t slot);
+
+	std::vector<Model> m_models;
+	std::array<int, TEMP_ID_BASE> m_slots;
+	std::vector<int> m_temp_slots;
+};
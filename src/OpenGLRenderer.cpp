@@ -1,16 +1,57 @@
 #include "Platform.h"
 #include "OpenGLRenderer.h"
+#include "ThumbnailAtlas.h"
+#include "Settings.h"
+#include "AllocTracker.h"
+#include "Sentinel.h"
 #include <functional>
 
+static constexpr auto THUMBNAIL_CACHE_DIR = "thumbnails";
+
+// Check whether any part of a model space box may be inside the clip volume
+// of a world-view-projection. Conservative, as a box is only rejected when
+// all of its corners are outside the same clip plane.
+static bool BoxInClipVolume(const BoundingBox& box, const XMMATRIX& wvp) {
+    XMFLOAT3 corners[BoundingBox::CORNER_COUNT];
+    box.GetCorners(corners);
+
+    uint32_t outsideAll = 0x3f;
+    for (auto& corner : corners) {
+        XMFLOAT4 clip;
+        XMStoreFloat4(&clip, XMVector4Transform(XMVectorSet(corner.x, corner.y, corner.z, 1.0f), wvp));
+
+        // Left handed projection, with clip space depth from 0 to w
+        uint32_t outside = 0;
+        if (clip.x < -clip.w) outside |= 0x01;
+        if (clip.x > clip.w) outside |= 0x02;
+        if (clip.y < -clip.w) outside |= 0x04;
+        if (clip.y > clip.w) outside |= 0x08;
+        if (clip.z < 0.0f) outside |= 0x10;
+        if (clip.z > clip.w) outside |= 0x20;
+
+        outsideAll &= outside;
+        if (!outsideAll) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 OpenGLRenderer::OpenGLRenderer(int width, int height)
     : m_width(width), m_height(height) {
 }
 
 OpenGLRenderer::~OpenGLRenderer() {
+    m_thumbnails.reset();
+
     // Cleanup OpenGL resources
     if (m_vao) {
         glDeleteVertexArrays(1, &m_vao);
     }
+    if (m_heightmapVAO) {
+        glDeleteVertexArrays(1, &m_heightmapVAO);
+    }
     if (m_sentinelProgram) {
         glDeleteProgram(m_sentinelProgram);
     }
@@ -42,6 +83,9 @@ OpenGLRenderer::~OpenGLRenderer() {
     for (auto& pair : m_modelIBOs) {
         glDeleteBuffers(1, &pair.second);
     }
+    for (auto& pair : m_heightmapTextures) {
+        glDeleteTextures(1, &pair.second);
+    }
 }
 
 bool OpenGLRenderer::Init() {
@@ -128,6 +172,14 @@ bool OpenGLRenderer::Init() {
         glUniformBlockBinding(m_sentinelProgram, pixelBlockIndexSentinel, 1);
     }
 
+    // Landscape heightmaps are always bound to texture unit 0
+    glUseProgram(m_sentinelProgram);
+    GLint heightmapLocation = glGetUniformLocation(m_sentinelProgram, "u_heightmap");
+    if (heightmapLocation != -1) {
+        glUniform1i(heightmapLocation, 0);
+    }
+    glUseProgram(0);
+
     GLuint pixelBlockIndexEffect = glGetUniformBlockIndex(m_effectProgram, "PixelConstants");
     if (pixelBlockIndexEffect != GL_INVALID_INDEX) {
         glUniformBlockBinding(m_effectProgram, pixelBlockIndexEffect, 1);
@@ -143,6 +195,9 @@ bool OpenGLRenderer::Init() {
     // Create VAO (vertex attributes will be set up per-draw in DrawModel)
     glGenVertexArrays(1, &m_vao);
 
+    // Landscape VAO without attributes, as its vertices are generated
+    glGenVertexArrays(1, &m_heightmapVAO);
+
     // Check for errors
     err = glGetError();
     if (err != GL_NO_ERROR) {
@@ -157,12 +212,21 @@ bool OpenGLRenderer::Init() {
     // Initialize framebuffers for post-processing (Phase 4.5)
     InitFramebuffers();
 
+    // Thumbnail atlas, cached on disk alongside the settings file
+    // Thumbnails are optional, so failure isn't fatal
+    m_thumbnails = std::make_unique<ThumbnailAtlas>();
+    if (!m_thumbnails->Init(fs::path(settings_path).replace_filename(THUMBNAIL_CACHE_DIR))) {
+        SDL_Log("WARNING: Thumbnail atlas unavailable");
+        m_thumbnails.reset();
+    }
+
     return true;
 }
 
 void OpenGLRenderer::BeginScene() {
     // Reset performance stats
     m_drawCallCount = 0;
+    m_culledModelCount = 0;
 
     // Phase 4.5: Conditional rendering path
     // If pixel shader effects are active, render to FBO for post-processing
@@ -223,6 +287,11 @@ void OpenGLRenderer::Render(IGame* pGame) {
 
     // Unbind VAO
     glBindVertexArray(0);
+
+    // Draw any thumbnails queued by the game over the scene
+    if (m_thumbnails) {
+        m_thumbnails->Render();
+    }
 }
 
 void OpenGLRenderer::EndScene() {
@@ -284,11 +353,7 @@ void OpenGLRenderer::DrawModel(Model& model, const Model& linkedModel) {
         return;
     }
 
-    // Upload if not already uploaded (using hash-based cache key)
-    const void* cacheKey = ComputeCacheKey(model);
-    if (!m_modelVBOs.count(cacheKey)) {
-        UploadModel(model);
-    }
+    AllocScope allocScope("DrawModel");
 
     // Calculate world matrix
     auto world = model.GetWorldMatrix(linkedModel);
@@ -298,6 +363,68 @@ void OpenGLRenderer::DrawModel(Model& model, const Model& linkedModel) {
     auto projection = model.orthographic ? GetOrthographicMatrix() : m_mViewProjection;
     auto wvp = world * projection;
 
+    // Skip models entirely outside the view, before any upload
+    if (!BoxInClipVolume(model.m_pMesh->Bounds(), wvp)) {
+        m_culledModelCount++;
+        return;
+    }
+
+    DrawVisibleModel(model, world, wvp);
+}
+
+void OpenGLRenderer::DrawModels(std::vector<Model>& models, const Model& linkedModel, int hiddenId) {
+    AllocScope allocScope("DrawModels");
+
+    // Cull every instance in one pass over the table, then draw the survivors
+    // with the world matrices it already holds
+    m_instances.Clear();
+    for (auto& model : models) {
+        m_instances.Add(model, linkedModel);
+    }
+    m_instances.Cull(m_mViewProjection);
+
+    for (size_t i = 0; i < models.size(); ++i) {
+        auto& model = models[i];
+        if (!model || (hiddenId >= 0 && model.id == hiddenId)) {
+            continue;
+        }
+
+        if (model.orthographic) {
+            DrawModel(model, linkedModel);
+        } else if (!m_instances.IsVisible(i)) {
+            m_culledModelCount++;
+        } else {
+            auto world = m_instances.GetWorldMatrix(i);
+            DrawVisibleModel(model, world, world * m_mViewProjection);
+        }
+    }
+}
+
+void OpenGLRenderer::DrawVisibleModel(Model& model, const XMMATRIX& world, const XMMATRIX& wvp) {
+    // The landscape is drawn from its heightmap, so its vertices are never uploaded
+    auto& heightmap = model.m_pMesh->Heightmap();
+    const bool heightfield = !heightmap.empty();
+
+    // Upload if not already uploaded (using hash-based cache key)
+    const void* cacheKey = ComputeCacheKey(model);
+    if (heightfield) {
+        UploadHeightmap(model);
+    } else if (!m_modelVBOs.count(cacheKey)) {
+        UploadModel(model);
+    }
+
+    // Upload just the vertices patched since the last draw
+    size_t dirtyFirst, dirtyCount;
+    if (!heightfield && model.m_pMesh->GetDirtyRange(dirtyFirst, dirtyCount)) {
+        auto dirty = model.m_pMesh->Vertices().begin() + dirtyFirst;
+        FrameVector<PackedVertex> packed(dirty, dirty + dirtyCount);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_modelVBOs.at(cacheKey));
+        glBufferSubData(GL_ARRAY_BUFFER, dirtyFirst * sizeof(PackedVertex), packed.size() * sizeof(PackedVertex),
+                        packed.data());
+        model.m_pMesh->ClearDirtyRange();
+    }
+
     // NOTE: DirectXMath matrices work directly with GLSL without transposition
     // Even though DirectXMath uses row-major and GLSL uses column-major,
     // the memory layout is compatible as-is.
@@ -310,6 +437,7 @@ void OpenGLRenderer::DrawModel(Model& model, const Model& linkedModel) {
 
     // Set lighting flag
     m_vertexConstants.lighting = model.lighting ? 1 : 0;
+    m_vertexConstants.heightfield = heightfield ? 1 : 0;
 
     // Set dissolved value
     m_pixelConstants.dissolved = model.dissolved;
@@ -318,30 +446,47 @@ void OpenGLRenderer::DrawModel(Model& model, const Model& linkedModel) {
     UpdateVertexConstants();
     UpdatePixelConstants();
 
+    if (heightfield) {
+        // 6 vertices per tile, generated in the vertex shader from gl_VertexID
+        glBindVertexArray(m_heightmapVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_heightmapTextures.at(heightmap.data()));
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(model.m_pMesh->Vertices().size()));
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindVertexArray(m_vao);
+        m_drawCallCount++;
+
+        GLenum err = glGetError();
+        if (err != GL_NO_ERROR) {
+            SDL_Log("ERROR: DrawModel failed for heightmap with GL error: 0x%x", err);
+        }
+        return;
+    }
+
     // Bind buffers (using hash-based cache key)
     glBindBuffer(GL_ARRAY_BUFFER, m_modelVBOs.at(cacheKey));
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_modelIBOs.at(cacheKey));
 
-    // Set up vertex attributes (same layout as test triangle)
+    // Set up vertex attributes for the packed vertex layout
     // Attribute 0: position (vec3)
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, pos));
 
-    // Attribute 1: normal (vec3)
+    // Attribute 1: octahedral normal (vec2, snorm8)
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glVertexAttribPointer(1, 2, GL_BYTE, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
 
-    // Attribute 2: color (uint)
+    // Attribute 2: colour index (uint8)
     glEnableVertexAttribArray(2);
-    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, colour));
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_BYTE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, colour));
 
-    // Attribute 3: texcoord (vec2)
+    // Attribute 3: texcoord bits (uint8)
     glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texcoord));
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_BYTE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, texcoord_bits));
 
     // Draw
     size_t indexCount = m_modelIndexCounts.at(cacheKey);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, indexCount, m_modelIndexTypes.at(cacheKey), 0);
     m_drawCallCount++;
 
     // Check for OpenGL errors
@@ -527,8 +672,8 @@ void OpenGLRenderer::UpdatePixelConstants() {
 const void* OpenGLRenderer::ComputeCacheKey(const Model& model) {
     // Compute hash of geometry data to use as cache key (more reliable than memory address)
     // Combine vertex buffer address, index buffer address, and sizes - unique per geometry instance
-    auto& vertices = *model.m_pVertices;
-    auto& indices = *model.m_pIndices;
+    auto& vertices = model.m_pMesh->Vertices();
+    auto& indices = model.m_pMesh->Indices();
 
     size_t hash1 = std::hash<const void*>{}(vertices.data());
     size_t hash2 = std::hash<const void*>{}(indices.data());
@@ -540,8 +685,8 @@ const void* OpenGLRenderer::ComputeCacheKey(const Model& model) {
 
 void OpenGLRenderer::UploadModel(const Model& model) {
     // Get vertex and index data from model
-    auto& vertices = *model.m_pVertices;
-    auto& indices = *model.m_pIndices;
+    auto& vertices = model.m_pMesh->Vertices();
+    auto& indices = model.m_pMesh->Indices();
 
     // Compute cache key using helper method
     const void* cacheKey = ComputeCacheKey(model);
@@ -551,20 +696,32 @@ void OpenGLRenderer::UploadModel(const Model& model) {
         return; // Already uploaded, reuse
     }
 
-    // Create VBO
+    // Create VBO, with the vertices in their packed GPU form
+    FrameVector<PackedVertex> packed(vertices.begin(), vertices.end());
+
     GLuint vbo;
     glGenBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex),
-                 vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex),
+                 packed.data(), GL_STATIC_DRAW);
     m_modelVBOs[cacheKey] = vbo;
+    model.m_pMesh->ClearDirtyRange();
 
     // Create IBO
     GLuint ibo;
     glGenBuffers(1, &ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t),
-                 indices.data(), GL_STATIC_DRAW);
+    if (model.m_pMesh->ShortIndices()) {
+        // Optimised meshes with few enough vertices use 16-bit indices
+        FrameVector<uint16_t> shortIndices(indices.begin(), indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t),
+                     shortIndices.data(), GL_STATIC_DRAW);
+        m_modelIndexTypes[cacheKey] = GL_UNSIGNED_SHORT;
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t),
+                     indices.data(), GL_STATIC_DRAW);
+        m_modelIndexTypes[cacheKey] = GL_UNSIGNED_INT;
+    }
     m_modelIBOs[cacheKey] = ibo;
     m_modelIndexCounts[cacheKey] = indices.size();
 
@@ -579,12 +736,76 @@ void OpenGLRenderer::UploadModel(const Model& model) {
     }
 }
 
+void OpenGLRenderer::UploadHeightmap(const Model& model) {
+    auto& heightmap = model.m_pMesh->Heightmap();
+    assert(heightmap.size() == SENTINEL_MAP_SIZE * SENTINEL_MAP_SIZE);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    auto it = m_heightmapTextures.find(heightmap.data());
+    if (it == m_heightmapTextures.end()) {
+        // One unsigned byte per map point, read with texelFetch so no filtering
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, SENTINEL_MAP_SIZE, SENTINEL_MAP_SIZE, 0,
+                     GL_RED_INTEGER, GL_UNSIGNED_BYTE, heightmap.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        m_heightmapTextures[heightmap.data()] = texture;
+    } else {
+        size_t first, count;
+        if (model.m_pMesh->GetHeightmapDirtyRange(first, count)) {
+            // Changes within a row upload just those texels, otherwise the rows holding them
+            int firstRow = static_cast<int>(first / SENTINEL_MAP_SIZE);
+            int lastRow = static_cast<int>((first + count - 1) / SENTINEL_MAP_SIZE);
+
+            glBindTexture(GL_TEXTURE_2D, it->second);
+            if (firstRow == lastRow) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<int>(first % SENTINEL_MAP_SIZE), firstRow,
+                                static_cast<int>(count), 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, &heightmap[first]);
+            } else {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, SENTINEL_MAP_SIZE, lastRow - firstRow + 1,
+                                GL_RED_INTEGER, GL_UNSIGNED_BYTE, &heightmap[firstRow * SENTINEL_MAP_SIZE]);
+            }
+        }
+    }
+
+    model.m_pMesh->ClearHeightmapDirtyRange();
+    model.m_pMesh->ClearDirtyRange();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        SDL_Log("ERROR: UploadHeightmap failed with GL error: 0x%x", err);
+    }
+}
+
 void OpenGLRenderer::SetVerticalFOV(float fov) {
     m_verticalFOV = fov;
 }
 
-void OpenGLRenderer::ClearModelCache() {
-    size_t count = m_modelVBOs.size();
+void OpenGLRenderer::ClearModelCache(const std::vector<const Model*>& keep) {
+    // Set aside the resources of models that are still in use
+    std::map<const void*, GLuint> keptVBOs, keptIBOs, keptTextures;
+    std::map<const void*, size_t> keptIndexCounts;
+    std::map<const void*, GLenum> keptIndexTypes;
+    for (auto pModel : keep) {
+        if (!pModel || !*pModel) {
+            continue;
+        }
+
+        const void* cacheKey = ComputeCacheKey(*pModel);
+        keptVBOs.insert(m_modelVBOs.extract(cacheKey));
+        keptIBOs.insert(m_modelIBOs.extract(cacheKey));
+        keptIndexCounts.insert(m_modelIndexCounts.extract(cacheKey));
+        keptIndexTypes.insert(m_modelIndexTypes.extract(cacheKey));
+        keptTextures.insert(m_heightmapTextures.extract(pModel->m_pMesh->Heightmap().data()));
+    }
 
     // Delete all VBOs
     for (auto& pair : m_modelVBOs) {
@@ -598,8 +819,112 @@ void OpenGLRenderer::ClearModelCache() {
     }
     m_modelIBOs.clear();
 
-    // Clear index counts
+    // Clear index counts and types
     m_modelIndexCounts.clear();
+    m_modelIndexTypes.clear();
+
+    // Delete all heightmap textures
+    for (auto& pair : m_heightmapTextures) {
+        glDeleteTextures(1, &pair.second);
+    }
+    m_heightmapTextures.clear();
+
+    m_modelVBOs = std::move(keptVBOs);
+    m_modelIBOs = std::move(keptIBOs);
+    m_modelIndexCounts = std::move(keptIndexCounts);
+    m_modelIndexTypes = std::move(keptIndexTypes);
+    m_heightmapTextures = std::move(keptTextures);
+}
+
+void OpenGLRenderer::ReleaseModel(const Model& model) {
+    if (!model) {
+        return;
+    }
+
+    auto textureIt = m_heightmapTextures.find(model.m_pMesh->Heightmap().data());
+    if (textureIt != m_heightmapTextures.end()) {
+        glDeleteTextures(1, &textureIt->second);
+        m_heightmapTextures.erase(textureIt);
+    }
+
+    const void* cacheKey = ComputeCacheKey(model);
+    auto it = m_modelVBOs.find(cacheKey);
+    if (it == m_modelVBOs.end()) {
+        return;
+    }
+
+    glDeleteBuffers(1, &it->second);
+    m_modelVBOs.erase(it);
+
+    glDeleteBuffers(1, &m_modelIBOs.at(cacheKey));
+    m_modelIBOs.erase(cacheKey);
+    m_modelIndexCounts.erase(cacheKey);
+    m_modelIndexTypes.erase(cacheKey);
+}
+
+// Landscape thumbnails
+
+bool OpenGLRenderer::HasThumbnail(int id) {
+    return m_thumbnails && m_thumbnails->Contains(id);
+}
+
+void OpenGLRenderer::RenderThumbnail(int id, const Camera& camera, Model& landscape,
+                                     std::vector<Model>& models, const std::vector<XMFLOAT4>& palette) {
+    if (!m_thumbnails) {
+        return;
+    }
+
+    // Save the scene state we're about to borrow
+    auto savedCamera = m_camera;
+    auto savedViewProjection = m_mViewProjection;
+    auto savedPalette = m_vertexConstants.Palette;
+    auto savedPixelConstants = m_pixelConstants;
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // Thumbnails are drawn without any view effects
+    m_camera = camera;
+    SetPalette(palette);
+    m_pixelConstants = {};
+    XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(m_verticalFOV), GetThumbnailAspectRatio(), NEAR_CLIP, FAR_CLIP);
+    m_mViewProjection = camera.GetViewMatrix() * proj;
+
+    m_thumbnails->BeginCell(m_vertexConstants.Palette[m_fill_colour_idx]);
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CW);
+
+    glUseProgram(m_sentinelProgram);
+    glBindVertexArray(m_vao);
+
+    DrawModel(landscape);
+    DrawModels(models, landscape);
+
+    glBindVertexArray(0);
+
+    m_thumbnails->EndCell(id);
+
+    // Restore the scene state
+    m_camera = savedCamera;
+    m_mViewProjection = savedViewProjection;
+    m_vertexConstants.Palette = savedPalette;
+    m_pixelConstants = savedPixelConstants;
+    UpdateVertexConstants();
+    UpdatePixelConstants();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void OpenGLRenderer::DrawThumbnail(int id, float x, float y, float width, float height, bool selected) {
+    if (m_thumbnails) {
+        m_thumbnails->Queue(id, x, y, width, height, selected);
+    }
+}
+
+float OpenGLRenderer::GetThumbnailAspectRatio() const {
+    return static_cast<float>(ThumbnailAtlas::CELL_WIDTH) / ThumbnailAtlas::CELL_HEIGHT;
 }
 
 // Framebuffer management (Phase 4.5)
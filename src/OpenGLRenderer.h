@@ -1,6 +1,9 @@
 #pragma once
 #include "Platform.h"
 #include "View.h"
+#include "InstanceTable.h"
+
+class ThumbnailAtlas;
 
 class OpenGLRenderer : public View {
 public:
@@ -15,6 +18,7 @@ public:
     void EndScene() override;
 
     void DrawModel(Model& model, const Model& linkedModel = {}) override;
+    void DrawModels(std::vector<Model>& models, const Model& linkedModel = {}, int hiddenId = -1) override;
     void DrawControllers() override;  // Stub for VR (not used in flat mode)
     bool IsPointerVisible() const override;
 
@@ -35,11 +39,19 @@ public:
 
     // Performance stats
     uint32_t GetDrawCallCount() const { return m_drawCallCount; }
+    uint32_t GetCulledModelCount() const { return m_culledModelCount; }
     uint32_t GetModelCount() const { return m_modelVBOs.size(); }
-    void ResetStats() { m_drawCallCount = 0; }
+    void ResetStats() { m_drawCallCount = 0; m_culledModelCount = 0; }
 
     // Model cache management
-    void ClearModelCache();
+    void ClearModelCache(const std::vector<const Model*>& keep = {});
+    void ReleaseModel(const Model& model);
+
+    // Landscape thumbnails, rendered offscreen into an atlas
+    bool HasThumbnail(int id);
+    void RenderThumbnail(int id, const Camera& camera, Model& landscape, std::vector<Model>& models, const std::vector<XMFLOAT4>& palette);
+    void DrawThumbnail(int id, float x, float y, float width, float height, bool selected);
+    float GetThumbnailAspectRatio() const;
 
 private:
     // Shader loading helpers
@@ -51,8 +63,12 @@ private:
     void UpdateVertexConstants();
     void UpdatePixelConstants();
 
-    // Model upload helper
+    // Draw a model already known to be in view
+    void DrawVisibleModel(Model& model, const XMMATRIX& world, const XMMATRIX& wvp);
+
+    // Model upload helpers
     void UploadModel(const Model& model);
+    void UploadHeightmap(const Model& model);
 
     // Cache key computation helper
     const void* ComputeCacheKey(const Model& model);
@@ -82,7 +98,19 @@ private:
     std::map<const void*, GLuint> m_modelVBOs;
     std::map<const void*, GLuint> m_modelIBOs;
     std::map<const void*, size_t> m_modelIndexCounts;
+    std::map<const void*, GLenum> m_modelIndexTypes;
+
+    // Landscape heightmap textures, keyed by heightmap data pointer
+    // The landscape vertices are generated from them in the vertex shader
+    std::map<const void*, GLuint> m_heightmapTextures;
+    GLuint m_heightmapVAO{0};  // no attributes, vertices come from gl_VertexID
+
+    std::unique_ptr<ThumbnailAtlas> m_thumbnails;
+
+    // Per-instance arrays for culling the models drawn together
+    InstanceTable m_instances;
 
     // Performance tracking
     uint32_t m_drawCallCount{0};
+    uint32_t m_culledModelCount{0};     // outside the view frustum
 };
@@ -34,7 +34,9 @@
 #include <array>
 #include <vector>
 #include <map>
+#include <tuple>
 #include <set>
+#include <bitset>
 #include <memory>
 #include <string>
 #include <fstream>
@@ -95,6 +97,8 @@ using namespace DirectX;
 // Map uppercase ASCII to SDL lowercase keycodes
 #define VK_A          SDLK_a
 #define VK_B          SDLK_b
+#define VK_F          SDLK_f
+#define VK_G          SDLK_g
 #define VK_H          SDLK_h
 #define VK_M          SDLK_m
 #define VK_N          SDLK_n
@@ -103,6 +107,7 @@ using namespace DirectX;
 #define VK_R          SDLK_r
 #define VK_T          SDLK_t
 #define VK_U          SDLK_u
+#define VK_Z          SDLK_z
 
 // SDL mouse button mappings
 #define VK_LBUTTON    (1000 + SDL_BUTTON_LEFT)
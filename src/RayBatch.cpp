@@ -0,0 +1,44 @@
+#include "Platform.h"
+#include "RayBatch.h"
+#include "JobSystem.h"
+
+constexpr size_t MIN_RAYS_PER_RANGE = 16;	// fewer rays than this aren't worth another thread.
+
+void RayBatch::Clear()
+{
+	m_rays.clear();
+	m_hits.clear();
+	m_targets.clear();
+}
+
+// Add a ray, returning its index for reading the result after Run.
+size_t RayBatch::Add(XMVECTOR vRayPos, XMVECTOR vRayDir)
+{
+	Ray ray;
+	XMStoreFloat3(&ray.pos, vRayPos);
+	XMStoreFloat3(&ray.dir, vRayDir);
+	m_rays.push_back(ray);
+
+	return m_rays.size() - 1;
+}
+
+void RayBatch::Run(const RayTestFunction& ray_test)
+{
+	m_hits.assign(m_rays.size(), 0);
+	m_targets.assign(m_rays.size(), {});
+
+	auto test_range = [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; ++i)
+		{
+			XMVECTOR vRayPos{ m_rays[i].pos.x, m_rays[i].pos.y, m_rays[i].pos.z, 1.0f };
+			XMVECTOR vRayDir{ m_rays[i].dir.x, m_rays[i].dir.y, m_rays[i].dir.z, 0.0f };
+			m_hits[i] = ray_test(vRayPos, vRayDir, m_targets[i]);
+		}
+	};
+
+	if (auto pJobs = JobSystem::Current())
+		pJobs->ParallelFor(m_rays.size(), MIN_RAYS_PER_RANGE, test_range);
+	else
+		test_range(0, m_rays.size());
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Model.h"
+
+// Many rays tested together, with the nearest hit for each. The rays are
+// shared across the job system threads, so the test function must be safe to
+// call from several threads at once. Models it tests need UpdateMatrices
+// calling first, so the threads don't rebuild their cached matrices. Storage
+// comes from the frame arena, so batches must not be kept beyond the frame.
+class RayBatch
+{
+public:
+	using RayTestFunction = std::function<bool(XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget& hit)>;
+
+	void Clear();
+	size_t Add(XMVECTOR vRayPos, XMVECTOR vRayDir);
+	void Run(const RayTestFunction& ray_test);
+
+	size_t Size() const { return m_rays.size(); }
+	bool IsHit(size_t idx) const { return m_hits[idx] != 0; }
+	const RayTarget& GetHit(size_t idx) const { return m_targets[idx]; }
+
+protected:
+	struct Ray
+	{
+		XMFLOAT3 pos;
+		XMFLOAT3 dir;
+	};
+
+	FrameVector<Ray> m_rays;
+	FrameVector<uint8_t> m_hits;		// not vector<bool>, so threads can write neighbouring entries.
+	FrameVector<RayTarget> m_targets;
+};
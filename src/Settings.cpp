@@ -5,11 +5,15 @@
 #include "SimpleIni.h"
 
 #include <fstream>
+#include <mutex>
 
 // Global settings instance
 static CSimpleIniA g_ini;
 static bool g_initialized = false;
 
+// Landscape generation reads settings from background threads
+static std::mutex g_mutex;
+
 std::wstring settings_path;
 
 // Helper: Convert wstring to UTF-8 string for SimpleIni
@@ -73,6 +77,7 @@ static void SaveSettings() {
 }
 
 void InitSettings(const std::string& app_name) {
+    std::lock_guard<std::mutex> lock(g_mutex);
     if (g_initialized) return;
 
     // Settings path should already be set by Application before this call
@@ -103,6 +108,7 @@ void InitSettings(const std::string& app_name) {
 std::vector<std::wstring> GetSettingKeys(const std::wstring& section) {
     std::vector<std::wstring> keys;
     if (!g_initialized) return keys;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
 
@@ -118,6 +124,7 @@ std::vector<std::wstring> GetSettingKeys(const std::wstring& section) {
 
 std::wstring GetSetting(const std::wstring& key, const std::wstring& default_value, const std::wstring& section) {
     if (!g_initialized) return default_value;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -129,6 +136,7 @@ std::wstring GetSetting(const std::wstring& key, const std::wstring& default_val
 
 int GetSetting(const std::wstring& key, int default_value, const std::wstring& section) {
     if (!g_initialized) return default_value;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -138,6 +146,7 @@ int GetSetting(const std::wstring& key, int default_value, const std::wstring& s
 
 bool GetFlag(const std::wstring& key, bool default_value, const std::wstring& section) {
     if (!g_initialized) return default_value;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -147,6 +156,7 @@ bool GetFlag(const std::wstring& key, bool default_value, const std::wstring& se
 
 void RemoveSetting(const std::wstring& key, const std::wstring& section) {
     if (!g_initialized) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -158,6 +168,7 @@ void RemoveSetting(const std::wstring& key, const std::wstring& section) {
 // Template specializations for SetSetting
 void SetSettingImpl(const std::wstring& key, const std::wstring& value, const std::wstring& section) {
     if (!g_initialized) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -169,6 +180,7 @@ void SetSettingImpl(const std::wstring& key, const std::wstring& value, const st
 
 void SetSettingImpl(const std::wstring& key, int value, const std::wstring& section) {
     if (!g_initialized) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
@@ -179,6 +191,7 @@ void SetSettingImpl(const std::wstring& key, int value, const std::wstring& sect
 
 void SetSettingImpl(const std::wstring& key, bool value, const std::wstring& section) {
     if (!g_initialized) return;
+    std::lock_guard<std::mutex> lock(g_mutex);
 
     std::string sec = ToUtf8(section);
     std::string k = ToUtf8(key);
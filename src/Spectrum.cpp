@@ -2,6 +2,8 @@
 #include "Spectrum.h"
 #include "Settings.h"
 #include "Vertex.h"
+#include <numeric>
+#include <mutex>
 
 static constexpr int SNA_HEADER_SIZE = 27;
 
@@ -134,18 +136,15 @@ Spectrum::Spectrum(std::wstring filename, ISentinelEvents* pEvents)
 			EndFrame();
 		});
 
-#ifdef _DEBUG
-	// Secret code check -- log expected/correct secret code in DEBUG ONLY!
-	Hook(0x85a9, 0x96, [&]
+	// Secret code check -- capture the expected code for the entered landscape.
+	Hook(0x85a9, 0x96 /*SUB (HL)*/, [&]
 		{
-			if (Z80_HL >= 0x60f0 && Z80_HL <= 0x60f3)
+			if (Z80_HL >= ZX_BCD_SECRET_CODE_ADDR && Z80_HL <= ZX_BCD_SECRET_CODE_ADDR + 3)
 			{
-				std::wstringstream ss;
-				ss << std::hex << Z80_HL << " = " << std::setw(2) << std::setfill(L'0') << (int)Z80_A << "\n";
-				OutputDebugString(ss.str().c_str());
+				auto shift = (Z80_HL - ZX_BCD_SECRET_CODE_ADDR) * 8;
+				m_expected_code_bcd = (m_expected_code_bcd & ~(0xffu << shift)) | (Z80_A << shift);
 			}
 		});
-#endif
 
 	// Secret code generation -- capture newly generated code.
 	Hook(0xafa9, 0xcd /*CALL nn*/, [&]
@@ -337,7 +336,7 @@ void Spectrum::LoadSnapshot(const std::wstring& filename)
 
 void Spectrum::RunFrame(bool interrupt)
 {
-	EmulateCycles(SPECTRUM_CYCLES_BEFORE_INT);
+	Emulate(SPECTRUM_CYCLES_BEFORE_INT);
 
 	if (interrupt)
 		RunInterrupt();
@@ -345,13 +344,42 @@ void Spectrum::RunFrame(bool interrupt)
 
 void Spectrum::RunInterrupt()
 {
+	m_stats.interrupts++;
+
 	// Run for interrupt active period.
 	ActivateInterrupt(true);
-	EmulateCycles(SPECTRUM_CYCLES_PER_INT);
+	Emulate(SPECTRUM_CYCLES_PER_INT);
 	ActivateInterrupt(false);
 
 	// Run until IM 2 handler returns.
-	EmulateCycles(SPECTRUM_CYCLES_PER_FRAME);
+	Emulate(SPECTRUM_CYCLES_PER_FRAME);
+}
+
+// Top-level emulation, gathering stats. Hooks use EmulateCycles directly.
+void Spectrum::Emulate(zusize cycles)
+{
+	auto start_time = std::chrono::high_resolution_clock::now();
+	auto start_instructions = m_z80.instructions;
+	m_end_frames = 0;
+
+	auto cycles_run = EmulateCycles(cycles);
+
+	// Exclude cycles added by EndFrame to stop emulation early.
+	m_stats.cycles += cycles_run - m_end_frames * SPECTRUM_CYCLES_PER_FRAME;
+	m_stats.instructions += m_z80.instructions - start_instructions;
+	m_stats.run_time_ms += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start_time).count();
+}
+
+// Clear the counters in place, keeping the hook addresses.
+void Spectrum::ResetStats()
+{
+	m_stats.cycles = 0;
+	m_stats.instructions = 0;
+	m_stats.interrupts = 0;
+	m_stats.run_time_ms = 0.0f;
+
+	for (size_t i = 0; i < m_stats.hook_count; ++i)
+		m_stats.hook_hits[i].hits = 0;
 }
 
 void Spectrum::Hook(uint16_t address, uint8_t expected_opcode, HookFunction fn)
@@ -364,9 +392,14 @@ void Spectrum::Hook(uint16_t address, uint8_t expected_opcode, HookFunction fn)
 		throw std::runtime_error("Snapshot is incompatible with code hooks.");
 	}
 
+	if (m_stats.hook_count == MAX_HOOKS)
+		throw std::runtime_error("Too many code hooks.");
+
 	HookData new_hook{};
 	new_hook.func = fn;
 	new_hook.orig_opcode = expected_opcode;
+	new_hook.stats_idx = m_stats.hook_count++;
+	m_stats.hook_hits[new_hook.stats_idx].address = address;
 
 	m_mem[address] = BREAKPOINT_OPCODE;
 	m_hooks[address] = new_hook;
@@ -378,6 +411,7 @@ void Spectrum::OnHook(uint16_t address)
 	if (it != m_hooks.end())
 	{
 		const auto& hook = it->second;
+		m_stats.hook_hits[hook.stats_idx].hits++;
 
 		// Unhook
 		m_mem[address] = hook.orig_opcode;
@@ -447,7 +481,8 @@ Model Spectrum::GetModel(int idx, bool ignore_under) const
 	return model;
 }
 
-uint8_t Spectrum::GetTileShape(int x, int z) const
+// Map entry for a vertex, looking through any objects placed on it.
+uint8_t Spectrum::GetMapEntry(int x, int z) const
 {
 	auto map_entry = m_mem[GetMapAddress(x, z)];
 	if (map_entry >= 0xc0)
@@ -459,7 +494,42 @@ uint8_t Spectrum::GetTileShape(int x, int z) const
 		}
 	}
 
-	return map_entry & 0xf;
+	return map_entry;
+}
+
+uint8_t Spectrum::GetTileShape(int x, int z) const
+{
+	return GetMapEntry(x, z) & 0xf;
+}
+
+LandscapeInfo Spectrum::GetLandscapeInfo() const
+{
+	LandscapeInfo info{};
+	info.landscape_bcd = (m_mem[ZX_BCD_LANDSCAPE_MSB] << 8) | m_mem[ZX_BCD_LANDSCAPE_LSB];
+	info.secret_code_bcd = m_expected_code_bcd;
+	info.sentries = m_mem[ZX_NUM_SENTS] - 1;
+
+	for (int z = 0; z < SENTINEL_MAP_SIZE; ++z)
+	{
+		for (int x = 0; x < SENTINEL_MAP_SIZE; ++x)
+			info.max_height = std::max(info.max_height, GetMapEntry(x, z) >> 4);
+	}
+
+	XMFLOAT3 sentinel_pos{};
+	for (auto& model : ExtractPlacedModels())
+	{
+		if (model.type == ModelType::Tree)
+			info.trees++;
+		else if (model.type == ModelType::Sentinel)
+			sentinel_pos = model.pos;
+	}
+
+	auto player_pos = ExtractPlayerModel().pos;
+	auto dx = sentinel_pos.x - player_pos.x;
+	auto dz = sentinel_pos.z - player_pos.z;
+	info.sentinel_distance = std::sqrt(dx * dx + dz * dz);
+
+	return info;
 }
 
 void Spectrum::LandscapeVertexIndexToTile(int vertex_index, int& tile_x, int& tile_z)
@@ -470,135 +540,206 @@ void Spectrum::LandscapeVertexIndexToTile(int vertex_index, int& tile_x, int& ti
 	tile_z = tile_index / (SENTINEL_MAP_SIZE - 1);
 }
 
-Model Spectrum::ExtractLandscape() const
+static bool SameVertex(const Vertex& a, const Vertex& b)
 {
-	std::vector<Vertex> vertices;
-	std::vector<uint32_t> indices;
+	return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.pos.z == b.pos.z &&
+		a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z &&
+		a.colour == b.colour && a.texcoord.x == b.texcoord.x && a.texcoord.y == b.texcoord.y;
+}
 
-	for (int z = 0; z < SENTINEL_MAP_SIZE - 1; ++z)
+// Vertices for one landscape tile, as two triangles with their own corners so
+// every tile has the same vertex count. The indices are simply 0,1,2,...
+std::array<Vertex, ZX_VERTICES_PER_TILE> Spectrum::LandscapeTileVertices(int x, int z) const
+{
+	uint8_t tile_entry = 0;
+	std::array<Vertex, 4> tile_vertices;
+	uint32_t colour{};
+
+	for (int zz = 0; zz < 2; ++zz)
 	{
-		for (int x = 0; x < SENTINEL_MAP_SIZE - 1; ++x)
+		for (int xx = 0; xx < 2; ++xx)
 		{
-			uint8_t tile_entry = 0;
-			std::array<Vertex, 4> tile_vertices;
-			uint32_t colour{};
+			auto map_x = (x + xx);
+			auto map_z = (z + zz);
+			auto offset = GetMapAddress(map_x, map_z);
+			auto map_entry = m_mem[offset];
 
-			for (int zz = 0; zz < 2; ++zz)
+			if (map_entry >= 0xc0)
 			{
-				for (int xx = 0; xx < 2; ++xx)
+				for (auto entry = map_entry; entry > 0x40; )
 				{
-					auto map_x = (x + xx);
-					auto map_z = (z + zz);
-					auto offset = GetMapAddress(map_x, map_z);
-					auto map_entry = m_mem[offset];
-
-					if (map_entry >= 0xc0)
-					{
-						for (auto entry = map_entry; entry > 0x40; )
-						{
-							map_entry = m_mem[ZX_OBJS_Y + (entry & 0x3f)] << 4;
-							entry = m_mem[ZX_OBJS_UNDER + (entry & 0x3f)];
-						}
-					}
-
-					if (xx == 0 && zz == 0)
-					{
-						tile_entry = map_entry;
-						bool alt_colour = ((x ^ z) & 1) != 0;
-
-						if (tile_entry & 0xf)
-							colour = alt_colour ? 0x10 : 0x11;	// sloped
-						else
-							colour = alt_colour ? 0x1 : 0x3;	// flat
-					}
-
-					float xxx = (map_x - (SENTINEL_MAP_SIZE / 2)) - 0.5f;
-					float yyy = (map_entry >> 4) * 1.0f;
-					float zzz = (map_z - (SENTINEL_MAP_SIZE / 2)) - 0.5f;
-
-					Vertex v{ xxx, yyy, zzz, colour, xx ? 1.0f : 0.0f, zz ? 1.0f : 0.0f };
-					tile_vertices[zz * 2 + xx] = std::move(v);
+					map_entry = m_mem[ZX_OBJS_Y + (entry & 0x3f)] << 4;
+					entry = m_mem[ZX_OBJS_UNDER + (entry & 0x3f)];
 				}
 			}
 
-			auto base_vertex = static_cast<uint32_t>(vertices.size());
-
-			switch (tile_entry & 0xf)
+			if (xx == 0 && zz == 0)
 			{
-			// Simple case: 4 vertices for 2 triangles (shared normals)
-			case 0b0000:	// flat
-			case 0b0001:	// slope facing back
-			case 0b0101:	// slope facing right
-			case 0b1001:	// slope facing front
-			case 0b1101:	// slope facing left
-				vertices.insert(vertices.end(), tile_vertices.begin(), tile_vertices.end());
-
-				indices.push_back(base_vertex + 0);
-				indices.push_back(base_vertex + 2);
-				indices.push_back(base_vertex + 3);
-
-				indices.push_back(base_vertex + 0);
-				indices.push_back(base_vertex + 3);
-				indices.push_back(base_vertex + 1);
-				break;
+				tile_entry = map_entry;
+				bool alt_colour = ((x ^ z) & 1) != 0;
 
-			// Corners: 6 vertices for 2 triangles (separate normals)
-			case 0b0010:	// inside corner, facing front
-			case 0b0011:	// inside corner, facing back
-			case 0b0100:	// stretched faces
-			case 0b1010:	// outside corner, facing front left
-			case 0b1011:	// outside corner, facing back right
-			case 0b1100:	// flat diagonal diamond
-				vertices.push_back(tile_vertices[0]);
-				vertices.push_back(tile_vertices[2]);
-				vertices.push_back(tile_vertices[3]);
-				indices.push_back(base_vertex + 0);
-				indices.push_back(base_vertex + 1);
-				indices.push_back(base_vertex + 2);
-
-				vertices.push_back(tile_vertices[0]);
-				vertices.push_back(tile_vertices[3]);
-				vertices.push_back(tile_vertices[1]);
-				indices.push_back(base_vertex + 3);
-				indices.push_back(base_vertex + 4);
-				indices.push_back(base_vertex + 5);
-				break;
+				if (tile_entry & 0xf)
+					colour = alt_colour ? 0x10 : 0x11;	// sloped
+				else
+					colour = alt_colour ? 0x1 : 0x3;	// flat
+			}
 
-			// Corners (other diagonal): 6 vertices for 2 triangles (separate normals)
-			case 0b0110:	// outside corner, facing front right
-			case 0b0111:	// inside corner, facing front right
-			case 0b1110:	// outside edge, facing back left
-			case 0b1111:	// inside edge, facing back left
-				vertices.push_back(tile_vertices[0]);
-				vertices.push_back(tile_vertices[2]);
-				vertices.push_back(tile_vertices[1]);
-				indices.push_back(base_vertex + 0);
-				indices.push_back(base_vertex + 1);
-				indices.push_back(base_vertex + 2);
-
-				vertices.push_back(tile_vertices[1]);
-				vertices.push_back(tile_vertices[2]);
-				vertices.push_back(tile_vertices[3]);
-				indices.push_back(base_vertex + 3);
-				indices.push_back(base_vertex + 4);
-				indices.push_back(base_vertex + 5);
-				break;
+			float xxx = (map_x - (SENTINEL_MAP_SIZE / 2)) - 0.5f;
+			float yyy = (map_entry >> 4) * 1.0f;
+			float zzz = (map_z - (SENTINEL_MAP_SIZE / 2)) - 0.5f;
 
-			case 0b1000:	// unused
-				break;
-			}
+			Vertex v{ xxx, yyy, zzz, colour, xx ? 1.0f : 0.0f, zz ? 1.0f : 0.0f };
+			tile_vertices[zz * 2 + xx] = std::move(v);
+		}
+	}
+
+	std::array<int, ZX_VERTICES_PER_TILE> corners;
+	switch (tile_entry & 0xf)
+	{
+	// Split from back left to front right.
+	case 0b0000:	// flat
+	case 0b0001:	// slope facing back
+	case 0b0101:	// slope facing right
+	case 0b1001:	// slope facing front
+	case 0b1101:	// slope facing left
+	case 0b0010:	// inside corner, facing front
+	case 0b0011:	// inside corner, facing back
+	case 0b0100:	// stretched faces
+	case 0b1010:	// outside corner, facing front left
+	case 0b1011:	// outside corner, facing back right
+	case 0b1100:	// flat diagonal diamond
+		corners = { 0, 2, 3, 0, 3, 1 };
+		break;
+
+	// Split from back right to front left.
+	case 0b0110:	// outside corner, facing front right
+	case 0b0111:	// inside corner, facing front right
+	case 0b1110:	// outside edge, facing back left
+	case 0b1111:	// inside edge, facing back left
+		corners = { 0, 2, 1, 1, 2, 3 };
+		break;
+
+	default:		// unused, so degenerate
+		corners = { 0, 0, 0, 0, 0, 0 };
+		break;
+	}
+
+	std::array<Vertex, ZX_VERTICES_PER_TILE> vertices;
+	for (size_t i = 0; i < vertices.size(); ++i)
+		vertices[i] = tile_vertices[corners[i]];
+
+	// Face normals, left as zero for degenerate triangles.
+	for (size_t i = 0; i < vertices.size(); i += 3)
+	{
+		auto v1 = XMLoadFloat3(&vertices[i + 0].pos);
+		auto v2 = XMLoadFloat3(&vertices[i + 1].pos);
+		auto v3 = XMLoadFloat3(&vertices[i + 2].pos);
+		auto n = XMVector3Normalize(XMVector3Cross(
+			XMVectorSubtract(v2, v1), XMVectorSubtract(v3, v2)));
+
+		if (!XMVector3IsNaN(n))
+		{
+			for (size_t j = i; j < i + 3; ++j)
+				XMStoreFloat3(&vertices[j].normal, n);
+		}
+	}
+
+	return vertices;
+}
+
+Model Spectrum::ExtractLandscape() const
+{
+	constexpr auto TILES = SENTINEL_MAP_SIZE - 1;
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(TILES * TILES * ZX_VERTICES_PER_TILE);
+
+	for (int z = 0; z < TILES; ++z)
+	{
+		for (int x = 0; x < TILES; ++x)
+		{
+			auto tile_vertices = LandscapeTileVertices(x, z);
+			vertices.insert(vertices.end(), tile_vertices.begin(), tile_vertices.end());
 		}
 	}
 
-	auto pVertices = std::make_shared<std::vector<Vertex>>(std::move(vertices));
-	auto pIndices = std::make_shared<std::vector<uint32_t>>(std::move(indices));
+	std::vector<uint32_t> indices(vertices.size());
+	std::iota(indices.begin(), indices.end(), 0);
 
-	auto landscape = Model{ pVertices, pIndices, ModelType::Landscape };
+	auto pMesh = std::make_shared<Mesh>(std::move(vertices), std::move(indices), ExtractHeightmap());
+	auto landscape = Model{ pMesh, ModelType::Landscape };
 	landscape.pos.x = SENTINEL_MAP_SIZE / 2;
 	landscape.pos.z = SENTINEL_MAP_SIZE / 2;
 	return landscape;
 }
 
+// Regenerate an extracted landscape for the current map in place, so only
+// the tiles that differ are changed (and uploaded again by the renderer).
+bool Spectrum::UpdateLandscape(Model& landscape) const
+{
+	assert(landscape.IsHeightfield());
+
+	bool changed = false;
+	for (int z = 0; z < SENTINEL_MAP_SIZE; ++z)
+	{
+		for (int x = 0; x < SENTINEL_MAP_SIZE; ++x)
+			changed |= UpdateHeightmapEntry(landscape, x, z);
+	}
+
+	for (int z = 0; z < SENTINEL_MAP_SIZE - 1; ++z)
+	{
+		for (int x = 0; x < SENTINEL_MAP_SIZE - 1; ++x)
+			changed |= UpdateLandscapeTileVertices(landscape, x, z);
+	}
+
+	if (changed)
+		landscape.EditMesh().UpdateBounds();
+
+	return changed;
+}
+
+bool Spectrum::UpdateLandscapeTileVertices(Model& landscape, int x, int z) const
+{
+	auto tile_vertices = LandscapeTileVertices(x, z);
+	auto first = static_cast<size_t>((z * (SENTINEL_MAP_SIZE - 1)) + x) * ZX_VERTICES_PER_TILE;
+
+	// Skip the copy-on-write if the tile is unchanged.
+	auto& vertices = landscape.m_pMesh->Vertices();
+	if (std::equal(tile_vertices.begin(), tile_vertices.end(), vertices.begin() + first, SameVertex))
+		return false;
+
+	landscape.EditMesh().UpdateVertices(first, tile_vertices.data(), tile_vertices.size());
+	return true;
+}
+
+bool Spectrum::UpdateHeightmapEntry(Model& landscape, int x, int z) const
+{
+	auto entry = GetMapEntry(x, z);
+	auto index = static_cast<size_t>(z * SENTINEL_MAP_SIZE + x);
+
+	if (landscape.m_pMesh->Heightmap()[index] == entry)
+		return false;
+
+	landscape.EditMesh().UpdateHeightmap(index, entry);
+	return true;
+}
+
+// Map entries for every map point, in rows of increasing x, for renderers
+// that generate the landscape vertices from them.
+std::vector<uint8_t> Spectrum::ExtractHeightmap() const
+{
+	std::vector<uint8_t> heightmap;
+	heightmap.reserve(SENTINEL_MAP_SIZE * SENTINEL_MAP_SIZE);
+
+	for (int z = 0; z < SENTINEL_MAP_SIZE; ++z)
+	{
+		for (int x = 0; x < SENTINEL_MAP_SIZE; ++x)
+			heightmap.push_back(GetMapEntry(x, z));
+	}
+
+	return heightmap;
+}
+
 std::vector<Model> Spectrum::ExtractText() const
 {
 	std::vector<Model> models;
@@ -654,6 +795,30 @@ Model Spectrum::ExtractPlayerModel() const
 	return model;
 }
 
+// Build a model with an optimised and interned mesh, adding its sizes before
+// and after optimisation to the totals.
+static Model OptimisedModel(std::vector<Vertex>&& vertices, std::vector<uint32_t>&& indices, ModelType type,
+	MeshStats& before, MeshStats& after)
+{
+	auto pMesh = std::make_unique<Mesh>(std::move(vertices), std::move(indices));
+	before += pMesh->Stats();
+	pMesh->Optimise();
+	after += pMesh->Stats();
+
+	return Model{ MeshRef::Interned(std::move(pMesh)), type };
+}
+
+static void LogMeshStats(const char* what, const MeshStats& before, const MeshStats& after, bool debug)
+{
+	const char* format = "%s: %zu vertices, %zu triangles, %zu bytes (optimised from %zu, %zu, %zu)";
+	if (debug)
+		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, format, what,
+			after.vertices, after.triangles, after.bytes, before.vertices, before.triangles, before.bytes);
+	else
+		SDL_Log(format, what,
+			after.vertices, after.triangles, after.bytes, before.vertices, before.triangles, before.bytes);
+}
+
 std::vector<Model> Spectrum::ExtractModels()
 {
 	auto vertex_indices = array_slice<NUM_MODELS + 1>(m_mem, ZX_VERTEX_INDICES_ADDR);
@@ -676,6 +841,7 @@ std::vector<Model> Spectrum::ExtractModels()
 	}
 
 	m_models.clear();
+	MeshStats before, after;
 
 	for (int m = 0; m < NUM_MODELS; ++m)
 	{
@@ -712,13 +878,14 @@ std::vector<Model> Spectrum::ExtractModels()
 			}
 		}
 
-		auto pVertices = std::make_shared<std::vector<Vertex>>(std::move(vertices));
-		auto pIndices = std::make_shared<std::vector<uint32_t>>(std::move(indices));
-
-		auto model = Model{ pVertices, pIndices, static_cast<ModelType>(m) };
+		auto model = OptimisedModel(std::move(vertices), std::move(indices), static_cast<ModelType>(m), before, after);
 		m_models.push_back(std::move(model));
 	}
 
+	// Every snapshot has the same models, so only report them once.
+	static std::once_flag logged;
+	std::call_once(logged, [&] { LogMeshStats("Models", before, after, false); });
+
 	return m_models;
 }
 
@@ -768,7 +935,18 @@ std::vector<CharBlock> BitsToBlocks(std::vector<uint8_t> bits)
 	return blocks;
 }
 
-void AppendExtrudedBlock(const CharBlock& block, std::vector<Vertex>& char_vertices, std::vector<uint32_t>& char_indices, uint32_t colour, float scale_x, float scale_y)
+// Faces of an extruded block, so shared faces can be left out.
+enum ExtrudedFace : uint32_t
+{
+	FaceFront = 1 << 0,
+	FaceTop = 1 << 1,
+	FaceRight = 1 << 2,
+	FaceBottom = 1 << 3,
+	FaceLeft = 1 << 4,
+	FaceBack = 1 << 5,
+};
+
+void AppendExtrudedBlock(const CharBlock& block, uint32_t faces, std::vector<Vertex>& char_vertices, std::vector<uint32_t>& char_indices, uint32_t colour, float scale_x, float scale_y)
 {
 	float z_front = 0.0f;
 	float z_back = 0.2f;
@@ -804,11 +982,14 @@ void AppendExtrudedBlock(const CharBlock& block, std::vector<Vertex>& char_verti
 	};
 
 	// Offset indices to account for vertices already in the buffer.
-	for (auto fi : face_indices)
+	for (size_t f = 0; f < face_indices.size(); ++f)
 	{
+		if (!(faces & (1 << f)))
+			continue;
+
 		auto base_vertex = static_cast<int>(char_vertices.size());
 
-		for (auto i : fi)
+		for (auto i : face_indices[f])
 			char_vertices.push_back(corner_vertices[i]);
 
 		static std::vector<uint32_t> triangle_indices{ 0, 1, 2,  1, 3, 2 };
@@ -817,25 +998,134 @@ void AppendExtrudedBlock(const CharBlock& block, std::vector<Vertex>& char_verti
 	}
 }
 
-Model Spectrum::CharToModel(char ch, int colour) const
+// Extrude the set pixels of a bitmap (bit 7 on the left), without the faces
+// shared by neighbouring pixels. The front and back are the greedy rectangles
+// from BitsToBlocks, and each run of exposed side wall is merged into one face.
+void ExtrudeBitmap(const std::vector<uint8_t>& bits, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t colour, float scale_x, float scale_y)
+{
+	for (const auto& block : BitsToBlocks(bits))
+		AppendExtrudedBlock(block, FaceFront | FaceBack, vertices, indices, colour, scale_x, scale_y);
+
+	auto rows = static_cast<int>(bits.size());
+	auto is_set = [&](int x, int y)
+	{
+		return x >= 0 && x < 8 && y >= 0 && y < rows && (bits[y] & (0x80 >> x));
+	};
+
+	// Top and bottom walls, merged along each row.
+	for (auto [face, dy] : { std::make_pair(FaceTop, -1), std::make_pair(FaceBottom, 1) })
+	{
+		for (int y = 0; y < rows; ++y)
+		{
+			for (int x = 0; x < 8; )
+			{
+				auto exposed = [&](int xx) { return is_set(xx, y) && !is_set(xx, y + dy); };
+				if (!exposed(x))
+				{
+					++x;
+					continue;
+				}
+
+				int start = x;
+				while (exposed(x))
+					++x;
+
+				AppendExtrudedBlock({ start, y, x - start, 1 }, face, vertices, indices, colour, scale_x, scale_y);
+			}
+		}
+	}
+
+	// Left and right walls, merged down each column.
+	for (auto [face, dx] : { std::make_pair(FaceLeft, -1), std::make_pair(FaceRight, 1) })
+	{
+		for (int x = 0; x < 8; ++x)
+		{
+			for (int y = 0; y < rows; )
+			{
+				auto exposed = [&](int yy) { return is_set(x, yy) && !is_set(x + dx, yy); };
+				if (!exposed(y))
+				{
+					++y;
+					continue;
+				}
+
+				int start = y;
+				while (exposed(y))
+					++y;
+
+				AppendExtrudedBlock({ x, start, 1, y - start }, face, vertices, indices, colour, scale_x, scale_y);
+			}
+		}
+	}
+}
+
+Model Spectrum::CharToModel(char ch, int colour)
 {
 	constexpr float scale_x = 0.1f;
 	constexpr float scale_y = 0.05f;
 
+	auto key = std::make_pair(ch, colour);
+	auto it = m_glyph_cache.find(key);
+	if (it != m_glyph_cache.end())
+		return it->second;
+
 	auto addr = ZX_GAME_FONT_ADDR + (ch - ' ') * 8;
 	std::vector<uint8_t> char_data(m_mem.begin() + addr, m_mem.begin() + addr + 8);
 
-	auto blocks = BitsToBlocks(char_data);
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	ExtrudeBitmap(char_data, vertices, indices, colour, scale_x, scale_y);
+
+	MeshStats before, after;
+	auto model = OptimisedModel(std::move(vertices), std::move(indices), ModelType::Letter, before, after);
+	LogMeshStats("Glyph", before, after, true);
+
+	m_glyph_cache[key] = model;
+	return model;
+}
+
+// A line of text as a single model, with each letter's glyph offset along
+// the x axis by letter_spacing (in model units). Strings are cached whole,
+// so repeated text shares one mesh and one GPU buffer.
+Model Spectrum::TextToModel(const std::string& str, int colour, float letter_spacing)
+{
+	auto key = std::make_tuple(str, colour, letter_spacing);
+	auto it = m_text_cache.find(key);
+	if (it != m_text_cache.end())
+		return it->second;
 
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
-	for (const auto& block : blocks)
-		AppendExtrudedBlock(block, vertices, indices, colour, scale_x, scale_y);
 
-	auto pVertices = std::make_shared<std::vector<Vertex>>(std::move(vertices));
-	auto pIndices = std::make_shared<std::vector<uint32_t>>(std::move(indices));
+	for (size_t i = 0; i < str.length(); ++i)
+	{
+		if (str[i] == ' ')
+			continue;
+
+		auto glyph = CharToModel(str[i], colour);
+		auto base_vertex = static_cast<uint32_t>(vertices.size());
+		auto x_offset = i * letter_spacing;
 
-	return Model{ pVertices, pIndices, ModelType::Letter };
+		for (auto vertex : glyph.m_pMesh->Vertices())
+		{
+			vertex.pos.x += x_offset;
+			vertices.push_back(std::move(vertex));
+		}
+
+		for (auto index : glyph.m_pMesh->Indices())
+			indices.push_back(base_vertex + index);
+	}
+
+	if (vertices.empty())
+		return {};
+
+	// The glyphs are already optimised, but this sets the index size for the whole string.
+	auto pMesh = std::make_shared<Mesh>(std::move(vertices), std::move(indices));
+	pMesh->Optimise();
+
+	auto model = Model{ pMesh, ModelType::Letter };
+	m_text_cache[key] = model;
+	return model;
 }
 
 Model Spectrum::IconToModel(int icon_idx, int colour)
@@ -851,17 +1141,14 @@ Model Spectrum::IconToModel(int icon_idx, int colour)
 	auto addr = ZX_PANEL_ICONS_ADDR + icon_idx * 8;
 	std::vector<uint8_t> char_data(m_mem.begin() + addr, m_mem.begin() + addr + 7);
 
-	auto blocks = BitsToBlocks(char_data);
-
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
-	for (const auto& block : blocks)
-		AppendExtrudedBlock(block, vertices, indices, colour, scale_x, scale_y);
+	ExtrudeBitmap(char_data, vertices, indices, colour, scale_x, scale_y);
 
-	auto pVertices = std::make_shared<std::vector<Vertex>>(std::move(vertices));
-	auto pIndices = std::make_shared<std::vector<uint32_t>>(std::move(indices));
+	MeshStats before, after;
+	auto model = OptimisedModel(std::move(vertices), std::move(indices), ModelType::Icon, before, after);
+	LogMeshStats("Icon", before, after, true);
 
-	auto model = Model{ pVertices, pIndices, ModelType::Icon };
 	m_icon_cache[key] = model;
 	return model;
 }
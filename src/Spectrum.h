@@ -37,7 +37,7 @@ static constexpr auto DEFAULT_HEX_LANDSCAPES = false;
 
 #define EmulateCycles(cycles)		z80_run(&m_z80, cycles)
 #define ActivateInterrupt(enable)	z80_int(&m_z80, enable)
-#define EndFrame()					Z80_CYCLES += SPECTRUM_CYCLES_PER_FRAME
+#define EndFrame()					(Z80_CYCLES += SPECTRUM_CYCLES_PER_FRAME, m_end_frames++)
 
 const uint8_t BREAKPOINT_OPCODE = 0x64;	// LD H,H
 
@@ -53,6 +53,34 @@ static constexpr int SPECTRUM_CYCLES_BEFORE_INT = SPECTRUM_CYCLES_PER_FRAME - SP
 
 enum class SeenState { Unseen, HalfSeen, FullSeen };
 
+static constexpr size_t MAX_HOOKS = 32;
+
+struct HookHits
+{
+	uint16_t address{ 0 };
+	uint32_t hits{ 0 };
+};
+
+struct EmulationStats
+{
+	uint64_t cycles{ 0 };
+	uint64_t instructions{ 0 };
+	uint32_t interrupts{ 0 };
+	float run_time_ms{ 0.0f };
+	std::array<HookHits, MAX_HOOKS> hook_hits{};	// in the order the hooks were added.
+	size_t hook_count{ 0 };
+};
+
+struct LandscapeInfo
+{
+	int landscape_bcd{ 0 };
+	uint32_t secret_code_bcd{ 0 };
+	int sentries{ 0 };				// excluding the Sentinel
+	int max_height{ 0 };
+	int trees{ 0 };
+	float sentinel_distance{ 0.0f };	// horizontal tiles from player to Sentinel
+};
+
 class Spectrum
 {
 public:
@@ -63,15 +91,20 @@ public:
 	void RunInterrupt();
 
 	void GetLandscapeAndCode(int& landscape_bcd, uint32_t& secret_code_bcd) const;
+	LandscapeInfo GetLandscapeInfo() const;
 	Model GetModel(ModelType type) const;
 	Model GetModel(int idx, bool ignore_under = false) const;
+	uint8_t GetMapEntry(int x, int z) const;
 	uint8_t GetTileShape(int x, int z) const;
 	void LandscapeVertexIndexToTile(int vertex_index, int& tile_x, int& tile_z);
 	Model ExtractLandscape() const;
+	std::vector<uint8_t> ExtractHeightmap() const;
+	bool UpdateLandscape(Model& landscape) const;
 	std::vector<Model> ExtractText() const;
 	Model ExtractPlayerModel() const;
 	std::vector<Model> ExtractPlacedModels() const;
-	Model CharToModel(char ch, int colour) const;
+	Model CharToModel(char ch, int colour);
+	Model TextToModel(const std::string& str, int colour, float letter_spacing);
 	Model IconToModel(int icon_idx, int colour);
 	std::vector<XMFLOAT4> GetGamePalette(int num_sentries = -1) const;
 	std::vector<XMFLOAT4> GetTitlePalette() const;
@@ -79,18 +112,31 @@ public:
 	void SetPlayerYaw(float radians);
 	SeenState GetPlayerSeenState() const;
 
+	const EmulationStats& GetStats() const { return m_stats; }
+	void ResetStats();
+
 protected:
 	ISentinelEvents* m_pEvents{ nullptr };
 
 	std::vector<Model> ExtractModels();
+	std::array<Vertex, ZX_VERTICES_PER_TILE> LandscapeTileVertices(int x, int z) const;
+	bool UpdateLandscapeTileVertices(Model& landscape, int x, int z) const;
+	bool UpdateHeightmapEntry(Model& landscape, int x, int z) const;
 	Vertex PolarToCartesian(uint8_t yaw, float y, uint8_t mag) const;
 
 	Z80 m_z80{};
+	EmulationStats m_stats{};
+	int m_end_frames{ 0 };
+
+	void Emulate(zusize cycles);
 
 	uint32_t m_secret_code_bcd{};
+	uint32_t m_expected_code_bcd{};
 	std::vector<uint8_t> m_mem;
 	std::vector<Model> m_models;
 	std::map<std::pair<int, int>, Model> m_icon_cache;
+	std::map<std::pair<char, int>, Model> m_glyph_cache;
+	std::map<std::tuple<std::string, int, float>, Model> m_text_cache;
 
 	void Push(uint16_t value);
 	uint16_t Pop();
@@ -108,6 +154,7 @@ protected:
 	{
 		HookFunction func{ nullptr };
 		uint8_t orig_opcode{ 0 };
+		size_t stats_idx{ 0 };
 	};
 	std::map<uint16_t, HookData> m_hooks;
 };
@@ -0,0 +1,342 @@
+#include "ThumbnailAtlas.h"
+
+// Quad shaders for atlas cells (solid colour when no cell slot is given)
+static const char* thumbnailVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec2 a_texcoord;
+
+out vec2 v_texcoord;
+
+uniform vec2 u_position;
+uniform vec2 u_size;
+uniform vec2 u_uvOffset;
+uniform vec2 u_uvScale;
+
+void main() {
+    // Convert from screen coordinates to clip space (-1 to 1)
+    vec2 pos = a_position * u_size + u_position;
+    pos = pos * 2.0 - 1.0;  // [0,1] -> [-1,1]
+    pos.y = -pos.y;  // Flip Y
+
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    // Rendered cells are stored bottom-up
+    v_texcoord = u_uvOffset + vec2(a_texcoord.x, 1.0 - a_texcoord.y) * u_uvScale;
+}
+)";
+
+static const char* thumbnailFragmentShader = R"(
+#version 330 core
+in vec2 v_texcoord;
+out vec4 fragColor;
+
+uniform sampler2D u_texture;
+uniform vec4 u_colour;
+uniform int u_textured;
+
+void main() {
+    fragColor = (u_textured != 0) ? texture(u_texture, v_texcoord) : u_colour;
+}
+)";
+
+static constexpr auto CELL_BYTES = ThumbnailAtlas::CELL_WIDTH * ThumbnailAtlas::CELL_HEIGHT * 4;
+static constexpr auto SELECTED_BORDER = 0.006f;  // highlight border, in normalised screen units
+
+ThumbnailAtlas::ThumbnailAtlas()
+    : m_slotIds(CAPACITY, -1), m_slotUsed(CAPACITY, 0) {
+}
+
+ThumbnailAtlas::~ThumbnailAtlas() {
+    if (m_atlasTexture) glDeleteTextures(1, &m_atlasTexture);
+    if (m_cellFBO) glDeleteFramebuffers(1, &m_cellFBO);
+    if (m_cellTexture) glDeleteTextures(1, &m_cellTexture);
+    if (m_cellDepthRBO) glDeleteRenderbuffers(1, &m_cellDepthRBO);
+
+    if (m_quadVBO) glDeleteBuffers(1, &m_quadVBO);
+    if (m_quadVAO) glDeleteVertexArrays(1, &m_quadVAO);
+    if (m_quadProgram) glDeleteProgram(m_quadProgram);
+}
+
+bool ThumbnailAtlas::Init(const fs::path& cacheDir) {
+    m_cacheDir = cacheDir;
+
+    // Atlas texture holding every cached cell
+    glGenTextures(1, &m_atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Offscreen target for rendering a single cell
+    glGenFramebuffers(1, &m_cellFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_cellFBO);
+
+    glGenTextures(1, &m_cellTexture);
+    glBindTexture(GL_TEXTURE_2D, m_cellTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, CELL_WIDTH, CELL_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_cellTexture, 0);
+
+    glGenRenderbuffers(1, &m_cellDepthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_cellDepthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, CELL_WIDTH, CELL_HEIGHT);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_cellDepthRBO);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        SDL_Log("ERROR: Thumbnail framebuffer is not complete! Status: 0x%x", status);
+        return false;
+    }
+
+    // Compile quad shaders
+    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vs, 1, &thumbnailVertexShader, nullptr);
+    glCompileShader(vs);
+
+    GLint success;
+    glGetShaderiv(vs, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetShaderInfoLog(vs, 512, nullptr, log);
+        SDL_Log("ERROR: Thumbnail vertex shader compilation failed: %s", log);
+        return false;
+    }
+
+    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fs, 1, &thumbnailFragmentShader, nullptr);
+    glCompileShader(fs);
+
+    glGetShaderiv(fs, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetShaderInfoLog(fs, 512, nullptr, log);
+        SDL_Log("ERROR: Thumbnail fragment shader compilation failed: %s", log);
+        return false;
+    }
+
+    m_quadProgram = glCreateProgram();
+    glAttachShader(m_quadProgram, vs);
+    glAttachShader(m_quadProgram, fs);
+    glLinkProgram(m_quadProgram);
+
+    glGetProgramiv(m_quadProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetProgramInfoLog(m_quadProgram, 512, nullptr, log);
+        SDL_Log("ERROR: Thumbnail shader program linking failed: %s", log);
+        return false;
+    }
+
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    // Create VAO and VBO for the quad
+    glGenVertexArrays(1, &m_quadVAO);
+    glGenBuffers(1, &m_quadVBO);
+
+    glBindVertexArray(m_quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
+
+    // Quad vertices: position (xy) and texcoord (uv)
+    float vertices[] = {
+        // positions   // texcoords
+        0.0f, 1.0f,    0.0f, 1.0f,  // bottom-left
+        1.0f, 1.0f,    1.0f, 1.0f,  // bottom-right
+        0.0f, 0.0f,    0.0f, 0.0f,  // top-left
+        1.0f, 0.0f,    1.0f, 0.0f   // top-right
+    };
+
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    glBindVertexArray(0);
+
+    SDL_Log("ThumbnailAtlas: %d cells of %dx%d, cache: %s",
+            CAPACITY, CELL_WIDTH, CELL_HEIGHT, m_cacheDir.string().c_str());
+    return true;
+}
+
+bool ThumbnailAtlas::Contains(int id) {
+    if (FindSlot(id) >= 0) {
+        return true;
+    }
+
+    if (m_notCached.count(id)) {
+        return false;
+    }
+
+    // Try the disk cache, which holds raw RGBA cell pixels
+    std::ifstream file(CachePath(id), std::ios::binary);
+    std::vector<char> pixels(CELL_BYTES);
+    if (!file || !file.read(pixels.data(), pixels.size()) || file.peek() != EOF) {
+        m_notCached.insert(id);
+        return false;
+    }
+
+    int slot = AllocateSlot(id);
+    glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % COLUMNS) * CELL_WIDTH, (slot / COLUMNS) * CELL_HEIGHT,
+                    CELL_WIDTH, CELL_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return true;
+}
+
+void ThumbnailAtlas::BeginCell(const XMFLOAT4& clearColour) {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_cellFBO);
+    glViewport(0, 0, CELL_WIDTH, CELL_HEIGHT);
+
+    glClearColor(clearColour.x, clearColour.y, clearColour.z, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void ThumbnailAtlas::EndCell(int id) {
+    int slot = FindSlot(id);
+    if (slot < 0) {
+        slot = AllocateSlot(id);
+    }
+
+    // Copy straight from the bound cell framebuffer into the atlas slot
+    glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, (slot % COLUMNS) * CELL_WIDTH, (slot / COLUMNS) * CELL_HEIGHT,
+                        0, 0, CELL_WIDTH, CELL_HEIGHT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Save the cell so it doesn't need to be generated again
+    std::vector<char> pixels(CELL_BYTES);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, CELL_WIDTH, CELL_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    std::error_code ec;
+    fs::create_directories(m_cacheDir, ec);
+    std::ofstream file(CachePath(id), std::ios::binary);
+    if (!file || !file.write(pixels.data(), pixels.size())) {
+        SDL_Log("WARNING: Failed to write thumbnail cache: %s", CachePath(id).string().c_str());
+    }
+
+    m_notCached.erase(id);
+}
+
+void ThumbnailAtlas::Queue(int id, float x, float y, float width, float height, bool selected) {
+    m_queue.push_back({id, x, y, width, height, selected});
+}
+
+void ThumbnailAtlas::Render() {
+    if (m_queue.empty() || !m_quadProgram) {
+        return;
+    }
+
+    // Save OpenGL state
+    GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean cullFaceEnabled = glIsEnabled(GL_CULL_FACE);
+    GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    GLint blendSrc, blendDst;
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSrc);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDst);
+
+    // Set up for 2D rendering
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(m_quadProgram);
+    glBindVertexArray(m_quadVAO);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+    glUniform1i(glGetUniformLocation(m_quadProgram, "u_texture"), 0);
+
+    // Darken the scene behind the cells
+    RenderQuad(0.0f, 0.0f, 1.0f, 1.0f, m_backgroundColour, -1);
+
+    for (const auto& cell : m_queue) {
+        if (cell.selected) {
+            RenderQuad(cell.x - SELECTED_BORDER, cell.y - SELECTED_BORDER,
+                       cell.width + SELECTED_BORDER * 2.0f, cell.height + SELECTED_BORDER * 2.0f,
+                       m_selectedColour, -1);
+        }
+
+        // Cells not yet generated are drawn as placeholders
+        RenderQuad(cell.x, cell.y, cell.width, cell.height, m_placeholderColour, FindSlot(cell.id));
+    }
+
+    m_queue.clear();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    // Restore OpenGL state
+    if (!depthTestEnabled) glDisable(GL_DEPTH_TEST);
+    else glEnable(GL_DEPTH_TEST);
+
+    if (!cullFaceEnabled) glDisable(GL_CULL_FACE);
+    else glEnable(GL_CULL_FACE);
+
+    if (!blendEnabled) glDisable(GL_BLEND);
+    glBlendFunc(blendSrc, blendDst);
+}
+
+int ThumbnailAtlas::FindSlot(int id) {
+    auto it = std::find(m_slotIds.begin(), m_slotIds.end(), id);
+    if (it == m_slotIds.end()) {
+        return -1;
+    }
+
+    auto slot = static_cast<int>(it - m_slotIds.begin());
+    m_slotUsed[slot] = ++m_useCounter;
+    return slot;
+}
+
+int ThumbnailAtlas::AllocateSlot(int id) {
+    // Use a free slot, or evict the least recently used cell
+    auto it = std::find(m_slotIds.begin(), m_slotIds.end(), -1);
+    auto slot = (it != m_slotIds.end()) ?
+        static_cast<int>(it - m_slotIds.begin()) :
+        static_cast<int>(std::min_element(m_slotUsed.begin(), m_slotUsed.end()) - m_slotUsed.begin());
+
+    m_slotIds[slot] = id;
+    m_slotUsed[slot] = ++m_useCounter;
+    return slot;
+}
+
+fs::path ThumbnailAtlas::CachePath(int id) const {
+    char filename[16];
+    snprintf(filename, sizeof(filename), "%04X.rgba", id);
+    return m_cacheDir / filename;
+}
+
+void ThumbnailAtlas::RenderQuad(float x, float y, float width, float height, const XMFLOAT4& colour, int slot) {
+    glUniform2f(glGetUniformLocation(m_quadProgram, "u_position"), x, y);
+    glUniform2f(glGetUniformLocation(m_quadProgram, "u_size"), width, height);
+    glUniform4f(glGetUniformLocation(m_quadProgram, "u_colour"), colour.x, colour.y, colour.z, colour.w);
+    glUniform1i(glGetUniformLocation(m_quadProgram, "u_textured"), slot >= 0);
+
+    if (slot >= 0) {
+        glUniform2f(glGetUniformLocation(m_quadProgram, "u_uvOffset"),
+                    static_cast<float>((slot % COLUMNS) * CELL_WIDTH) / ATLAS_SIZE,
+                    static_cast<float>((slot / COLUMNS) * CELL_HEIGHT) / ATLAS_SIZE);
+        glUniform2f(glGetUniformLocation(m_quadProgram, "u_uvScale"),
+                    static_cast<float>(CELL_WIDTH) / ATLAS_SIZE,
+                    static_cast<float>(CELL_HEIGHT) / ATLAS_SIZE);
+    }
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "Platform.h"
+#include <string>
+#include <vector>
+
+// Small fixed-size images packed into a single texture, backed by a disk cache.
+// Cells are rendered offscreen between BeginCell/EndCell, then queued for
+// drawing as 2D quads over the scene.
+class ThumbnailAtlas {
+public:
+    static constexpr int CELL_WIDTH = 160;
+    static constexpr int CELL_HEIGHT = 120;
+    static constexpr int ATLAS_SIZE = 2048;
+    static constexpr int COLUMNS = ATLAS_SIZE / CELL_WIDTH;
+    static constexpr int ROWS = ATLAS_SIZE / CELL_HEIGHT;
+    static constexpr int CAPACITY = COLUMNS * ROWS;  // 204 cells
+
+    ThumbnailAtlas();
+    ~ThumbnailAtlas();
+
+    bool Init(const fs::path& cacheDir);
+
+    // Check for a cell, loading it from the disk cache if necessary.
+    bool Contains(int id);
+
+    // Bind the offscreen cell target and clear it.
+    void BeginCell(const XMFLOAT4& clearColour);
+    // Copy the rendered cell into the atlas and save it to the disk cache.
+    void EndCell(int id);
+
+    // Queue a cell for drawing, in normalised screen coordinates (0,0 = top-left).
+    void Queue(int id, float x, float y, float width, float height, bool selected);
+    void Render();
+
+    size_t GetCellCount() const { return m_slotIds.size() - std::count(m_slotIds.begin(), m_slotIds.end(), -1); }
+
+private:
+    struct QueuedCell {
+        int id;
+        float x, y, width, height;
+        bool selected;
+    };
+
+    int AllocateSlot(int id);
+    int FindSlot(int id);
+    fs::path CachePath(int id) const;
+    void RenderQuad(float x, float y, float width, float height, const XMFLOAT4& colour, int slot);
+
+    fs::path m_cacheDir;
+    std::vector<int> m_slotIds;          // id held in each atlas slot, or -1
+    std::vector<uint64_t> m_slotUsed;    // last use, for least recently used eviction
+    uint64_t m_useCounter{0};
+    std::set<int> m_notCached;           // ids known to be missing from the disk cache
+    std::vector<QueuedCell> m_queue;
+
+    GLuint m_atlasTexture{0};
+    GLuint m_cellFBO{0};
+    GLuint m_cellTexture{0};
+    GLuint m_cellDepthRBO{0};
+
+    GLuint m_quadProgram{0};
+    GLuint m_quadVAO{0};
+    GLuint m_quadVBO{0};
+
+    XMFLOAT4 m_backgroundColour{0.0f, 0.0f, 0.0f, 0.85f};
+    XMFLOAT4 m_placeholderColour{0.2f, 0.2f, 0.2f, 1.0f};
+    XMFLOAT4 m_selectedColour{1.0f, 1.0f, 0.0f, 1.0f};
+};
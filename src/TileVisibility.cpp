@@ -0,0 +1,261 @@
+#include "Platform.h"
+#include "TileVisibility.h"
+
+constexpr auto TILE_AXIS_SAMPLES = 5;	// tile visibility hit test samples per axis.
+constexpr auto TARGET_MARGIN = 0.001f;	// landscape this close to the target doesn't block it.
+constexpr auto GRAZE_HEIGHT = 0.0001f;	// a line grazing the landscape is blocked, as the ray test hits it.
+
+// Sight line results, with unusual cases left to a ray test.
+enum { SIGHT_HIDDEN, SIGHT_VISIBLE, SIGHT_UNKNOWN };
+
+void TileVisibility::Clear()
+{
+	m_visible.reset();
+	m_pMesh = nullptr;
+}
+
+// Gather the heights and triangle split of every tile, then test every tile
+// from the eye position. The result holds until the player moves or the
+// landscape changes.
+void TileVisibility::Build(const Model& landscape, XMVECTOR vEyePos)
+{
+	for (int z = 0; z < GRID_SIZE; ++z)
+	{
+		for (int x = 0; x < GRID_SIZE; ++x)
+		{
+			auto& tile = m_tiles[z * GRID_SIZE + x];
+			tile.min_y = FLT_MAX;
+			tile.max_y = -FLT_MAX;
+
+			// Tile (x,z) covers world x-0.5 to x+0.5 (and the same for z).
+			for (auto& vCorner : landscape.GetTileCorners(x, z))
+			{
+				XMFLOAT3 corner;
+				XMStoreFloat3(&corner, vCorner);
+				auto& y = (corner.z < z) ? ((corner.x < x) ? tile.y00 : tile.y10) : ((corner.x < x) ? tile.y01 : tile.y11);
+				y = corner.y;
+
+				tile.min_y = std::min(tile.min_y, corner.y);
+				tile.max_y = std::max(tile.max_y, corner.y);
+			}
+
+			// The vertices shared by both triangles are the ends of the split.
+			auto vertices = landscape.GetTileVertices(x, z);
+			FrameVector<XMFLOAT3> shared;
+			for (size_t i = 0; i < 3; ++i)
+			{
+				for (size_t j = 3; j < 6; ++j)
+				{
+					if (vertices[i].x == vertices[j].x && vertices[i].z == vertices[j].z)
+						shared.push_back(vertices[i]);
+				}
+			}
+
+			assert(shared.size() == 2);
+			tile.main_diagonal = (shared[1].x - shared[0].x) * (shared[1].z - shared[0].z) > 0.0f;
+		}
+	}
+
+	// Samples the sight lines can't settle are ray tested together afterwards.
+	RayBatch rays;
+	FrameVector<SampleRay> samples;
+
+	m_visible.reset();
+	for (int z = 0; z < GRID_SIZE; ++z)
+	{
+		for (int x = 0; x < GRID_SIZE; ++x)
+		{
+			if (TileSamplesVisible(vEyePos, x, z, rays, samples))
+				m_visible.set(z * GRID_SIZE + x);
+		}
+	}
+
+	// Threads only read the landscape's cached matrices.
+	landscape.UpdateMatrices();
+	rays.Run([&](XMVECTOR vRayPos, XMVECTOR vRayDir, RayTarget& hit)
+	{
+		return landscape.RayTest(vRayPos, vRayDir, hit);
+	});
+
+	// It's visible if we don't hit another part of the landscape before the sample,
+	// even if we miss it due to floating point precision errors.
+	for (size_t i = 0; i < rays.Size(); ++i)
+	{
+		if (!rays.IsHit(i) || rays.GetHit(i).distance > (samples[i].distance - TARGET_MARGIN))
+			m_visible.set(samples[i].tile_idx);
+	}
+
+	m_pMesh = landscape.m_pMesh.get();
+	m_mesh_version = m_pMesh->Version();
+	m_landscape_pos = landscape.pos;
+	XMStoreFloat3(&m_eye_pos, vEyePos);
+}
+
+bool TileVisibility::IsBuilt(const Model& landscape, XMVECTOR vEyePos) const
+{
+	XMFLOAT3 eye_pos;
+	XMStoreFloat3(&eye_pos, vEyePos);
+
+	return m_pMesh && m_pMesh == landscape.m_pMesh.get() && m_mesh_version == m_pMesh->Version() &&
+		m_landscape_pos.x == landscape.pos.x && m_landscape_pos.y == landscape.pos.y && m_landscape_pos.z == landscape.pos.z &&
+		m_eye_pos.x == eye_pos.x && m_eye_pos.y == eye_pos.y && m_eye_pos.z == eye_pos.z;
+}
+
+bool TileVisibility::IsVisible(int tile_x, int tile_z) const
+{
+	assert(tile_x >= 0 && tile_x < GRID_SIZE && tile_z >= 0 && tile_z < GRID_SIZE);
+	return m_visible.test(tile_z * GRID_SIZE + tile_x);
+}
+
+// Check the sight line to each sample point on a tile, stopping at the first
+// clear one. If none are, samples that need a ray test are added to the batch.
+bool TileVisibility::TileSamplesVisible(XMVECTOR vEyePos, int tile_x, int tile_z, RayBatch& rays, FrameVector<SampleRay>& samples) const
+{
+	XMFLOAT3 eye_pos{};
+	XMStoreFloat3(&eye_pos, vEyePos);
+
+	// Reject non-flat tiles, and those at/above eye height.
+	auto& tile = m_tiles[tile_z * GRID_SIZE + tile_x];
+	if (tile.min_y != tile.max_y || tile.max_y >= eye_pos.y)
+		return false;
+
+	std::array<XMFLOAT3, TILE_AXIS_SAMPLES * TILE_AXIS_SAMPLES> unknown_pos;
+	size_t num_unknown = 0;
+
+	// Scan across the tile surface in a grid pattern.
+	for (int z = 0; z < TILE_AXIS_SAMPLES; ++z)
+	{
+		for (int x = 0; x < TILE_AXIS_SAMPLES; ++x)
+		{
+			constexpr auto step = 1.0f / (TILE_AXIS_SAMPLES - 1);
+			XMFLOAT3 sample_pos{ tile_x - 0.5f + step * x, tile.min_y, tile_z - 0.5f + step * z };
+
+			auto sight = SightLineTest(eye_pos, sample_pos);
+			if (sight == SIGHT_VISIBLE)
+				return true;
+			else if (sight == SIGHT_UNKNOWN)
+				unknown_pos[num_unknown++] = sample_pos;
+		}
+	}
+
+	for (size_t i = 0; i < num_unknown; ++i)
+	{
+		// Calculate the vector to the sample position in world space, and its unit direction vector.
+		XMVECTOR vSample{ unknown_pos[i].x, unknown_pos[i].y, unknown_pos[i].z, 1.0f };
+		auto vRay = vSample - vEyePos;
+
+		float sample_dist;
+		XMStoreFloat(&sample_dist, XMVector3Length(vRay));
+
+		rays.Add(vEyePos, XMVector3Normalize(vRay));
+		samples.push_back({ tile_z * GRID_SIZE + tile_x, sample_dist });
+	}
+
+	// Not visible, unless a ray test finds otherwise.
+	return false;
+}
+
+// Landscape height at a world position inside a tile, from the plane of the
+// triangle containing it.
+float TileVisibility::TileHeight(int tile_x, int tile_z, float x, float z) const
+{
+	auto& tile = m_tiles[tile_z * GRID_SIZE + tile_x];
+	auto fx = x - (tile_x - 0.5f);
+	auto fz = z - (tile_z - 0.5f);
+
+	if (tile.main_diagonal)
+	{
+		if (fx >= fz)
+			return tile.y00 + fx * (tile.y10 - tile.y00) + fz * (tile.y11 - tile.y10);
+		else
+			return tile.y00 + fz * (tile.y01 - tile.y00) + fx * (tile.y11 - tile.y01);
+	}
+	else
+	{
+		if (fx + fz <= 1.0f)
+			return tile.y00 + fx * (tile.y10 - tile.y00) + fz * (tile.y01 - tile.y00);
+		else
+			return tile.y11 + (1.0f - fx) * (tile.y01 - tile.y11) + (1.0f - fz) * (tile.y10 - tile.y11);
+	}
+}
+
+// Sweep the sight line over the heightfield, tile by tile. Across each tile
+// both the line and the landscape under it are straight between the tile
+// edges and the triangle split, so comparing heights at those points tells
+// whether the landscape rises above the line before the target.
+int TileVisibility::SightLineTest(const XMFLOAT3& eye_pos, const XMFLOAT3& target_pos) const
+{
+	auto dx = target_pos.x - eye_pos.x;
+	auto dz = target_pos.z - eye_pos.z;
+	auto target_dist = std::sqrt(dx * dx + dz * dz);
+
+	// Tile (x,z) covers world x-0.5 to x+0.5, and the eye must be over the landscape.
+	auto tile_x = static_cast<int>(std::floor(eye_pos.x + 0.5f));
+	auto tile_z = static_cast<int>(std::floor(eye_pos.z + 0.5f));
+	if (target_dist < TARGET_MARGIN || tile_x < 0 || tile_x >= GRID_SIZE || tile_z < 0 || tile_z >= GRID_SIZE)
+		return SIGHT_UNKNOWN;
+
+	// Line height changes linearly with horizontal distance from the eye.
+	auto slope = (target_pos.y - eye_pos.y) / target_dist;
+	auto dir_x = dx / target_dist;
+	auto dir_z = dz / target_dist;
+
+	// Landscape close to the target doesn't count, as with the ray test.
+	auto length = std::sqrt(target_dist * target_dist + (target_pos.y - eye_pos.y) * (target_pos.y - eye_pos.y));
+	auto blocking_dist = target_dist * (1.0f - TARGET_MARGIN / length);
+
+	auto step_x = (dir_x > 0.0f) ? 1 : -1;
+	auto step_z = (dir_z > 0.0f) ? 1 : -1;
+	auto inf = std::numeric_limits<float>::infinity();
+	auto delta_x = (dir_x != 0.0f) ? std::abs(1.0f / dir_x) : inf;
+	auto delta_z = (dir_z != 0.0f) ? std::abs(1.0f / dir_z) : inf;
+	auto next_x = (dir_x != 0.0f) ? ((tile_x + 0.5f * step_x) - eye_pos.x) / dir_x : inf;
+	auto next_z = (dir_z != 0.0f) ? ((tile_z + 0.5f * step_z) - eye_pos.z) / dir_z : inf;
+
+	auto blocked = [&](int x, int z, float dist)
+	{
+		return dist < blocking_dist &&
+			TileHeight(x, z, eye_pos.x + dir_x * dist, eye_pos.z + dir_z * dist) > eye_pos.y + slope * dist - GRAZE_HEIGHT;
+	};
+
+	auto dist_in = 0.0f;
+	while (tile_x >= 0 && tile_x < GRID_SIZE && tile_z >= 0 && tile_z < GRID_SIZE)
+	{
+		auto dist_out = std::min({ next_x, next_z, target_dist });
+		auto& tile = m_tiles[tile_z * GRID_SIZE + tile_x];
+
+		// Only tiles rising above the lowest point of the line need a closer look.
+		if (tile.max_y > eye_pos.y + std::min(slope * dist_in, slope * dist_out) - GRAZE_HEIGHT)
+		{
+			// Where the line crosses the triangle split, if it does inside this tile.
+			auto x0 = tile_x - 0.5f - eye_pos.x;
+			auto z0 = tile_z - 0.5f - eye_pos.z;
+			auto split_dist = tile.main_diagonal ?
+				((dir_x != dir_z) ? (x0 - z0) / (dir_x - dir_z) : inf) :
+				((dir_x != -dir_z) ? (1.0f + x0 + z0) / (dir_x + dir_z) : inf);
+
+			if (blocked(tile_x, tile_z, dist_in) || blocked(tile_x, tile_z, dist_out) ||
+				(split_dist > dist_in && split_dist < dist_out && blocked(tile_x, tile_z, split_dist)))
+			{
+				return SIGHT_HIDDEN;
+			}
+		}
+
+		if (dist_out >= target_dist)
+			break;
+
+		dist_in = dist_out;
+		if (next_x < next_z)
+		{
+			tile_x += step_x;
+			next_x += delta_x;
+		}
+		else
+		{
+			tile_z += step_z;
+			next_z += delta_z;
+		}
+	}
+
+	return SIGHT_VISIBLE;
+}
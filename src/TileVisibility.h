@@ -0,0 +1,43 @@
+#pragma once
+#include "Model.h"
+#include "RayBatch.h"
+
+// Which landscape tiles can be seen from an eye position, worked out for the
+// whole map at once so repeated tile checks from the same position are cheap.
+class TileVisibility
+{
+public:
+	void Clear();
+	void Build(const Model& landscape, XMVECTOR vEyePos);
+	bool IsBuilt(const Model& landscape, XMVECTOR vEyePos) const;
+
+	bool IsVisible(int tile_x, int tile_z) const;
+	size_t Count() const { return m_visible.count(); }
+
+protected:
+	static constexpr int GRID_SIZE = SENTINEL_MAP_SIZE - 1;
+
+	struct TileInfo
+	{
+		float y00, y10, y01, y11;	// corner heights, at (-x,-z) (+x,-z) (-x,+z) (+x,+z).
+		float min_y, max_y;
+		bool main_diagonal;			// triangles split from (-x,-z) to (+x,+z)?
+	};
+
+	struct SampleRay
+	{
+		int tile_idx;
+		float distance;
+	};
+
+	bool TileSamplesVisible(XMVECTOR vEyePos, int tile_x, int tile_z, RayBatch& rays, FrameVector<SampleRay>& samples) const;
+	int SightLineTest(const XMFLOAT3& eye_pos, const XMFLOAT3& target_pos) const;
+	float TileHeight(int tile_x, int tile_z, float x, float z) const;
+
+	std::bitset<GRID_SIZE * GRID_SIZE> m_visible;
+	std::array<TileInfo, GRID_SIZE * GRID_SIZE> m_tiles{};
+	const Mesh* m_pMesh{ nullptr };
+	uint32_t m_mesh_version{ 0 };
+	XMFLOAT3 m_eye_pos{};
+	XMFLOAT3 m_landscape_pos{};
+};
@@ -0,0 +1,175 @@
+#include "Platform.h"
+#include "TriangleSoA.h"
+#include "Vertex.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRIANGLE_SOA_SSE
+#endif
+
+// Reject rays almost parallel to a triangle, as TriangleTests::Intersects does.
+static constexpr float RAY_EPSILON = 1e-20f;
+
+TriangleSoA::TriangleSoA(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+	m_count = indices.size() / 3;
+
+	// Padding entries are left zeroed, so their determinant is zero.
+	auto padded = (m_count + LANES - 1) / LANES * LANES;
+	for (auto* v : { &m_v0x, &m_v0y, &m_v0z, &m_e1x, &m_e1y, &m_e1z, &m_e2x, &m_e2y, &m_e2z })
+		v->resize(padded);
+
+	for (size_t i = 0; i < m_count; ++i)
+	{
+		auto& p0 = vertices[indices[i * 3 + 0]].pos;
+		auto& p1 = vertices[indices[i * 3 + 1]].pos;
+		auto& p2 = vertices[indices[i * 3 + 2]].pos;
+
+		m_v0x[i] = p0.x;
+		m_v0y[i] = p0.y;
+		m_v0z[i] = p0.z;
+		m_e1x[i] = p1.x - p0.x;
+		m_e1y[i] = p1.y - p0.y;
+		m_e1z[i] = p1.z - p0.z;
+		m_e2x[i] = p2.x - p0.x;
+		m_e2y[i] = p2.y - p0.y;
+		m_e2z[i] = p2.z - p0.z;
+	}
+}
+
+/*static*/ bool TriangleSoA::HasSIMD()
+{
+#ifdef TRIANGLE_SOA_SSE
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Double-sided Moller-Trumbore, one triangle at a time.
+bool TriangleSoA::RayTestScalar(const XMFLOAT3& o, const XMFLOAT3& d, float& dist, size_t& tri) const
+{
+	auto closest_dist = std::numeric_limits<float>::max();
+	auto closest_tri = std::numeric_limits<size_t>::max();
+
+	for (size_t i = 0; i < m_count; ++i)
+	{
+		auto px = d.y * m_e2z[i] - d.z * m_e2y[i];
+		auto py = d.z * m_e2x[i] - d.x * m_e2z[i];
+		auto pz = d.x * m_e2y[i] - d.y * m_e2x[i];
+		auto det = m_e1x[i] * px + m_e1y[i] * py + m_e1z[i] * pz;
+		if (std::abs(det) <= RAY_EPSILON)
+			continue;
+
+		auto inv_det = 1.0f / det;
+		auto sx = o.x - m_v0x[i];
+		auto sy = o.y - m_v0y[i];
+		auto sz = o.z - m_v0z[i];
+		auto u = (sx * px + sy * py + sz * pz) * inv_det;
+		if (u < 0.0f || u > 1.0f)
+			continue;
+
+		auto qx = sy * m_e1z[i] - sz * m_e1y[i];
+		auto qy = sz * m_e1x[i] - sx * m_e1z[i];
+		auto qz = sx * m_e1y[i] - sy * m_e1x[i];
+		auto v = (d.x * qx + d.y * qy + d.z * qz) * inv_det;
+		if (v < 0.0f || u + v > 1.0f)
+			continue;
+
+		auto t = (m_e2x[i] * qx + m_e2y[i] * qy + m_e2z[i] * qz) * inv_det;
+		if (t >= 0.0f && t < closest_dist)
+		{
+			closest_dist = t;
+			closest_tri = i;
+		}
+	}
+
+	if (closest_tri >= m_count)
+		return false;
+
+	dist = closest_dist;
+	tri = closest_tri;
+	return true;
+}
+
+// The same test on LANES triangles per iteration. Each lane keeps its own
+// nearest hit, and the lanes are combined at the end.
+bool TriangleSoA::RayTest(const XMFLOAT3& o, const XMFLOAT3& d, float& dist, size_t& tri) const
+{
+#ifdef TRIANGLE_SOA_SSE
+	static_assert(LANES == 4, "SSE path tests 4 triangles per iteration");
+
+	auto ox = _mm_set1_ps(o.x), oy = _mm_set1_ps(o.y), oz = _mm_set1_ps(o.z);
+	auto dx = _mm_set1_ps(d.x), dy = _mm_set1_ps(d.y), dz = _mm_set1_ps(d.z);
+	auto zero = _mm_setzero_ps();
+	auto one = _mm_set1_ps(1.0f);
+	auto epsilon = _mm_set1_ps(RAY_EPSILON);
+	auto sign_mask = _mm_set1_ps(-0.0f);
+
+	auto closest_dist = _mm_set1_ps(std::numeric_limits<float>::max());
+	auto closest_tri = _mm_set1_epi32(-1);
+	auto lane_tri = _mm_set_epi32(3, 2, 1, 0);
+	auto lane_step = _mm_set1_epi32(static_cast<int>(LANES));
+
+	for (size_t i = 0; i < m_v0x.size(); i += LANES)
+	{
+		auto e1x = _mm_loadu_ps(&m_e1x[i]), e1y = _mm_loadu_ps(&m_e1y[i]), e1z = _mm_loadu_ps(&m_e1z[i]);
+		auto e2x = _mm_loadu_ps(&m_e2x[i]), e2y = _mm_loadu_ps(&m_e2y[i]), e2z = _mm_loadu_ps(&m_e2z[i]);
+
+		auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+		auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+		auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+		auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+		auto inv_det = _mm_div_ps(one, det);
+
+		auto sx = _mm_sub_ps(ox, _mm_loadu_ps(&m_v0x[i]));
+		auto sy = _mm_sub_ps(oy, _mm_loadu_ps(&m_v0y[i]));
+		auto sz = _mm_sub_ps(oz, _mm_loadu_ps(&m_v0z[i]));
+		auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv_det);
+
+		auto qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+		auto qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+		auto qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+		auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+		auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+
+		// Comparisons with NaN are false, so padding and parallel rays drop out.
+		auto mask = _mm_cmpgt_ps(_mm_andnot_ps(sign_mask, det), epsilon);
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+		mask = _mm_and_ps(mask, _mm_cmplt_ps(t, closest_dist));
+
+		closest_dist = _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, closest_dist));
+		auto imask = _mm_castps_si128(mask);
+		closest_tri = _mm_or_si128(_mm_and_si128(imask, lane_tri), _mm_andnot_si128(imask, closest_tri));
+		lane_tri = _mm_add_epi32(lane_tri, lane_step);
+	}
+
+	alignas(16) float lane_dist[LANES];
+	alignas(16) int32_t lane_hit[LANES];
+	_mm_store_ps(lane_dist, closest_dist);
+	_mm_store_si128(reinterpret_cast<__m128i*>(lane_hit), closest_tri);
+
+	// Pick the nearest lane, preferring the lowest triangle on a tie as the scalar loop does.
+	auto found = false;
+	for (size_t lane = 0; lane < LANES; ++lane)
+	{
+		if (lane_hit[lane] < 0)
+			continue;
+
+		auto lane_tri_idx = static_cast<size_t>(lane_hit[lane]);
+		if (!found || lane_dist[lane] < dist || (lane_dist[lane] == dist && lane_tri_idx < tri))
+		{
+			dist = lane_dist[lane];
+			tri = lane_tri_idx;
+			found = true;
+		}
+	}
+
+	return found;
+#else
+	return RayTestScalar(o, d, dist, tri);
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+struct Vertex;
+
+// Triangles stored as separate x/y/z arrays of their first vertex and two
+// edges, so the ray test can run the same intersection on several triangles
+// at once. Arrays are padded to a whole number of lanes with degenerate
+// triangles, which never hit.
+class TriangleSoA
+{
+public:
+	static constexpr size_t LANES = 4;
+
+	TriangleSoA(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+	size_t Size() const { return m_count; }
+
+	// Find the nearest triangle hit at or beyond the ray origin, returning its
+	// triangle number (first vertex index / 3). Uses SSE where available.
+	bool RayTest(const XMFLOAT3& origin, const XMFLOAT3& dir, float& dist, size_t& tri) const;
+
+	// Plain C++ version of the same test, used where SSE isn't available.
+	bool RayTestScalar(const XMFLOAT3& origin, const XMFLOAT3& dir, float& dist, size_t& tri) const;
+
+	static bool HasSIMD();
+
+protected:
+	size_t m_count{ 0 };
+	std::vector<float> m_v0x, m_v0y, m_v0z;
+	std::vector<float> m_e1x, m_e1y, m_e1z;
+	std::vector<float> m_e2x, m_e2y, m_e2z;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 
 struct Vertex
 {
@@ -10,3 +11,43 @@ struct Vertex
 	uint32_t colour{};
 	XMFLOAT2 texcoord{};
 };
+
+// Compact 16-byte form of a vertex for GPU buffers. Normals are stored as
+// octahedral snorm8 pairs, and texcoords (only ever 0 or 1) as bits.
+struct PackedVertex
+{
+	PackedVertex() = default;
+	explicit PackedVertex(const Vertex& v)
+		: pos(v.pos), colour(static_cast<uint8_t>(v.colour))
+	{
+		// Project onto the octahedron, folding the lower half over the upper.
+		auto n = v.normal;
+		auto l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+		float px = 0.0f, py = 0.0f;
+		if (l1 > 0.0f)
+		{
+			px = n.x / l1;
+			py = n.y / l1;
+
+			if (n.z < 0.0f)
+			{
+				auto fx = (1.0f - std::fabs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+				auto fy = (1.0f - std::fabs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+				px = fx;
+				py = fy;
+			}
+		}
+
+		normal[0] = static_cast<int8_t>(std::lround(std::clamp(px, -1.0f, 1.0f) * 127.0f));
+		normal[1] = static_cast<int8_t>(std::lround(std::clamp(py, -1.0f, 1.0f) * 127.0f));
+
+		assert(v.colour <= 0xff);
+		texcoord_bits = (v.texcoord.x >= 0.5f ? 1 : 0) | (v.texcoord.y >= 0.5f ? 2 : 0);
+	}
+
+	XMFLOAT3 pos{};
+	int8_t normal[2]{};
+	uint8_t colour{};
+	uint8_t texcoord_bits{};
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be 16 bytes");
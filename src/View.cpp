@@ -371,6 +371,15 @@ void View::DrawModel(Model &model, const Model &linkedModel)
     // Stub for Phase 1 - will be implemented in OpenGLRenderer
 }
 
+void View::DrawModels(std::vector<Model> &models, const Model &linkedModel, int hidden_id)
+{
+    for (auto &model : models)
+    {
+        if (hidden_id < 0 || model.id != hidden_id)
+            DrawModel(model, linkedModel);
+    }
+}
+
 void View::DrawControllers()
 {
     // Stub for VR - not used in Phase 1
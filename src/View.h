@@ -40,7 +40,7 @@ struct VertexConstants
 	float fog_density{};
 	uint32_t fog_colour_idx{};
 	uint32_t lighting{};
-	uint32_t padding{};  // Ensure 16-byte alignment
+	uint32_t heightfield{};  // landscape generated from the heightmap texture
 };
 static_assert((sizeof(VertexConstants) & 0xf) == 0, "VS constants size must be multiple of 16");
 
@@ -112,6 +112,7 @@ public:
 	virtual void EndScene() = 0;
 
 	void DrawModel(Model& model, const Model& linkedModel = {}) override;
+	void DrawModels(std::vector<Model>& models, const Model& linkedModel = {}, int hidden_id = -1) override;
 	void DrawControllers() override;
 
 	void EnableFreeLook(bool enable);
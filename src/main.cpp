@@ -1,18 +1,214 @@
 #include "Platform.h"
 #include "Application.h"
+#include "LandscapeIndex.h"
+#include "Settings.h"
+
+// Build or query the landscape property index, without creating a window.
+static int RunLandscapeIndexTool(bool buildIndex, const std::string& query) {
+    Application::InitPaths();
+    InitSettings(APP_NAME);
+
+    LandscapeIndex index;
+    auto indexPath = LandscapeIndex::DefaultPath();
+
+    if (buildIndex) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        index.Build(GetFlag(HEX_LANDSCAPES_KEY, DEFAULT_HEX_LANDSCAPES), [](int done, int total) {
+            if (done % 500 == 0 || done == total)
+                SDL_Log("Generated %d/%d landscapes", done, total);
+        });
+        float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        if (!index.Save(indexPath)) {
+            SDL_Log("Failed to save landscape index: %s", to_string(indexPath).c_str());
+            return 1;
+        }
+        SDL_Log("Indexed %zu landscapes in %.1f s: %s", index.Size(), seconds, to_string(indexPath).c_str());
+    } else if (!index.Load(indexPath)) {
+        SDL_Log("No landscape index at %s (use --build-index)", to_string(indexPath).c_str());
+        return 1;
+    }
+
+    if (!query.empty()) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto matches = index.Query(query);
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        printf("landscape,code,sentries,height,trees,distance\n");
+        for (auto* info : matches) {
+            printf("%04X,%08X,%d,%d,%d,%.2f\n", info->landscape_bcd, info->secret_code_bcd,
+                   info->sentries, info->max_height, info->trees, info->sentinel_distance);
+        }
+        SDL_Log("%zu of %zu landscapes matched in %.2f ms", matches.size(), index.Size(), ms);
+    }
+
+    return 0;
+}
+
+// Time the per-triangle ray test paths against the meshes of a generated
+// landscape: DirectXMath TriangleTests, the scalar SoA loop, and the SIMD SoA
+// kernel. All three should agree on the nearest triangle.
+static int RunRayTestBenchmark(int rayCount) {
+    Application::InitPaths();
+    InitSettings(APP_NAME);
+
+    // The landscape is left out, as heightfields are ray tested from their heightmap
+    auto geometry = LandscapeIndex::GenerateGeometry(0x0000);
+    std::vector<const Model*> meshes;
+    for (auto& model : geometry.models)
+        meshes.push_back(&model);
+
+    // Rays start around and above each mesh, aimed through its bounding box.
+    struct Ray { const Model* mesh; XMFLOAT3 origin, dir; };
+    std::vector<Ray> rays;
+    rays.reserve(rayCount);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < rayCount; i++) {
+        auto* mesh = meshes[i % meshes.size()];
+        auto& box = mesh->m_pMesh->Bounds();
+        auto radius = std::max({ box.Extents.x, box.Extents.y, box.Extents.z }) * 3.0f;
+        XMFLOAT3 origin{ box.Center.x + unit(rng) * radius, box.Center.y + std::abs(unit(rng)) * radius, box.Center.z + unit(rng) * radius };
+        XMFLOAT3 target{ box.Center.x + unit(rng) * box.Extents.x, box.Center.y + unit(rng) * box.Extents.y, box.Center.z + unit(rng) * box.Extents.z };
+        XMFLOAT3 dir;
+        XMStoreFloat3(&dir, XMVector3Normalize(XMVectorSubtract(XMLoadFloat3(&target), XMLoadFloat3(&origin))));
+        rays.push_back({ mesh, origin, dir });
+    }
+
+    std::vector<size_t> expected(rays.size());
+    auto timeRays = [&](const char* name, bool reference, std::function<size_t(const Ray&)> test) {
+        size_t hits = 0, mismatches = 0;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < rays.size(); i++) {
+            auto tri = test(rays[i]);
+            if (tri != SIZE_MAX)
+                hits++;
+            if (reference)
+                expected[i] = tri;
+            else if (tri != expected[i])
+                mismatches++;
+        }
+        float us = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - startTime).count();
+        SDL_Log("%-14s %8.3f us/ray  %zu hits  %zu mismatches", name, us / rays.size(), hits, mismatches);
+    };
+
+    size_t triangles = 0;
+    for (auto* mesh : meshes)
+        triangles += mesh->m_pMesh->Triangles()->Size();
+    SDL_Log("Ray testing %zu rays against %zu meshes (%zu triangles), SIMD %s",
+            rays.size(), meshes.size(), triangles, TriangleSoA::HasSIMD() ? "SSE" : "unavailable");
+
+    timeRays("TriangleTests", true, [](const Ray& ray) {
+        auto& vertices = ray.mesh->m_pMesh->Vertices();
+        auto& indices = ray.mesh->m_pMesh->Indices();
+        auto origin = XMVectorSet(ray.origin.x, ray.origin.y, ray.origin.z, 1.0f);
+        auto dir = XMVectorSet(ray.dir.x, ray.dir.y, ray.dir.z, 0.0f);
+        auto closest_dist = FLT_MAX, dist = 0.0f;
+        auto closest_tri = SIZE_MAX;
+        for (size_t idx = 0; idx < indices.size(); idx += 3) {
+            auto V0 = XMLoadFloat3(&vertices[indices[idx + 0]].pos);
+            auto V1 = XMLoadFloat3(&vertices[indices[idx + 1]].pos);
+            auto V2 = XMLoadFloat3(&vertices[indices[idx + 2]].pos);
+            if (TriangleTests::Intersects(origin, dir, V0, V1, V2, dist) && dist < closest_dist) {
+                closest_dist = dist;
+                closest_tri = idx / 3;
+            }
+        }
+        return closest_tri;
+    });
+
+    timeRays("SoA scalar", false, [](const Ray& ray) {
+        auto dist = 0.0f;
+        size_t tri = 0;
+        return ray.mesh->m_pMesh->Triangles()->RayTestScalar(ray.origin, ray.dir, dist, tri) ? tri : SIZE_MAX;
+    });
+
+    timeRays("SoA SIMD", false, [](const Ray& ray) {
+        auto dist = 0.0f;
+        size_t tri = 0;
+        return ray.mesh->m_pMesh->Triangles()->RayTest(ray.origin, ray.dir, dist, tri) ? tri : SIZE_MAX;
+    });
+
+    return 0;
+}
+
+// Time a parallel loop and recursively nested task groups on the job system,
+// against the same work on a single thread, and report the scheduler stats.
+static int RunJobSystemBenchmark() {
+    constexpr size_t LOOP_ITEMS = 4000000;
+    constexpr int TASK_DEPTH = 16;
+
+    std::vector<float> values(LOOP_ITEMS);
+    auto loopWork = [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++)
+            values[i] = std::sqrt(static_cast<float>(i)) * std::sin(static_cast<float>(i));
+    };
+
+    // Binary tree of tasks, each level waiting on its two children.
+    std::function<void(JobSystem&, int, std::atomic<int>&)> spawnTasks = [&](JobSystem& jobs, int depth, std::atomic<int>& leaves) {
+        if (depth == 0) {
+            leaves++;
+            return;
+        }
+        TaskGroup group(&jobs);
+        group.Run([&, depth] { spawnTasks(jobs, depth - 1, leaves); });
+        group.Run([&, depth] { spawnTasks(jobs, depth - 1, leaves); });
+        group.Wait();
+    };
+
+    for (auto numThreads : { 1u, std::max(1u, std::thread::hardware_concurrency()) }) {
+        JobSystem jobs(numThreads);
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        jobs.ParallelFor(values.size(), 1024, loopWork);
+        float loopMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        std::atomic<int> leaves{0};
+        startTime = std::chrono::high_resolution_clock::now();
+        spawnTasks(jobs, TASK_DEPTH, leaves);
+        float taskMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        auto stats = jobs.GetStats();
+        SDL_Log("%u thread(s): parallel_for %.2f ms, %d nested tasks %.2f ms", numThreads, loopMs, leaves.load(), taskMs);
+        SDL_Log("  %llu jobs, %llu steals, latency %.1f us avg, %llu us max",
+                static_cast<unsigned long long>(stats.jobs), static_cast<unsigned long long>(stats.steals),
+                stats.jobs ? static_cast<float>(stats.total_latency_us) / stats.jobs : 0.0f,
+                static_cast<unsigned long long>(stats.max_latency_us));
+    }
+
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
     try {
         // Parse command-line arguments
         bool dumpScreenshot = false;
+        bool buildIndex = false;
+        std::string query;
+        int benchRays = 0;
+        bool benchJobs = false;
         for (int i = 1; i < argc; i++) {
             std::string arg = argv[i];
             if (arg == "--screenshot" || arg == "-s") {
                 dumpScreenshot = true;
+            } else if (arg == "--build-index") {
+                buildIndex = true;
+            } else if (arg == "--query" && i + 1 < argc) {
+                query = argv[++i];
+            } else if (arg == "--bench-raytest") {
+                benchRays = (i + 1 < argc && argv[i + 1][0] != '-') ? atoi(argv[++i]) : 100000;
+            } else if (arg == "--bench-jobs") {
+                benchJobs = true;
             } else if (arg == "--help" || arg == "-h") {
                 SDL_Log("Usage: %s [options]", argv[0]);
                 SDL_Log("Options:");
                 SDL_Log("  --screenshot, -s   Render one frame, save screenshot.png, and exit");
+                SDL_Log("  --build-index      Generate every landscape and save the property index");
+                SDL_Log("  --query <query>    List indexed landscapes matching a query, and exit");
+                SDL_Log("                     e.g. \"sentries=4 trees>=20 distance<10\"");
+                SDL_Log("                     (properties: landscape code sentries height trees distance)");
+                SDL_Log("  --bench-raytest [n] Time the triangle ray test paths over n rays, and exit");
+                SDL_Log("  --bench-jobs       Time the job system against a single thread, and exit");
                 SDL_Log("  --help, -h         Show this help message");
                 return 0;
             } else {
@@ -22,6 +218,18 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        if (benchJobs) {
+            return RunJobSystemBenchmark();
+        }
+
+        if (benchRays > 0) {
+            return RunRayTestBenchmark(benchRays);
+        }
+
+        if (buildIndex || !query.empty()) {
+            return RunLandscapeIndexTool(buildIndex, query);
+        }
+
         Application app;
 
         if (!app.Init()) {
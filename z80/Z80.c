@@ -1588,6 +1588,7 @@ CPU_Z80_API zusize z80_run(Z80 *object, zusize cycles)
 		/*-----------------------------------------------.
 		| Execute instruction and update consumed cycles |
 		'-----------------------------------------------*/
+		object->instructions++; /* SNO */
 		CYCLES += instruction_table[BYTE0 = READ_8(PC)](object);
 		}
 
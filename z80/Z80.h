@@ -100,6 +100,12 @@ typedef struct {
 
 	void(* hook)(void *context, zuint16 address);
 
+	/** Total number of instructions executed.
+	  * @details Incremented for each instruction fetched by @c z80_run,
+	  * and never reset by the emulator. */
+
+	zusize instructions; /* SNO */
+
 	/** CPU registers and internal bits.
 	  * @details It contains the state of the registers, as well as the
 	  * interrupt flip-flops, variables related to interrupts and other